@@ -28,6 +28,8 @@ if(CMAKE_CXX_COMPILER_ID MATCHES "Clang|GNU")
             # uninit reads surface deterministically on macOS/Linux rather than
             # happening to read as zero
             $<$<BOOL:${USE_SANITIZER}>:-ftrivial-auto-var-init=pattern>
+            # Thread sanitizer, for the multi_instance test in particular
+            $<$<BOOL:${USE_TSAN}>:-fsanitize=thread>
 
             $<$<OR:$<COMPILE_LANGUAGE:CXX>,$<COMPILE_LANGUAGE:OBJC>,$<COMPILE_LANGUAGE:OBJCXX>>:-fno-char8_t>
     )
@@ -36,6 +38,7 @@ if(CMAKE_CXX_COMPILER_ID MATCHES "Clang|GNU")
             $<$<BOOL:${USE_SANITIZER}>:-fsanitize=address>
             $<$<BOOL:${USE_SANITIZER}>:-fsanitize=undefined>
             $<$<BOOL:${USE_SANITIZER}>:-fno-sanitize-recover=undefined>
+            $<$<BOOL:${USE_TSAN}>:-fsanitize=thread>
     )
     if (NOT APPLE)
         add_compile_options($<IF:$<STREQUAL:${CMAKE_SYSTEM_PROCESSOR},aarch64>,-march=armv8-a,-march=nehalem>)
@@ -0,0 +1,44 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#ifndef BACONPAUL_SIX_SINES_CLAP_ENGINE_STATS_EXT_H
+#define BACONPAUL_SIX_SINES_CLAP_ENGINE_STATS_EXT_H
+
+#include <clap/clap.h>
+#include "synth/engine_stats.h"
+
+/*
+ * A plugin extension so a test host or a triage tool can ask a running instance
+ * for its EngineStats, with or without its editor open. It is only offered by this
+ * build of Six Sines to code compiled against this header, so it shares the C++
+ * Snapshot rather than spelling out a C struct.
+ */
+static constexpr const char SIX_SINES_EXT_ENGINE_STATS[] = "org.baconpaul.six-sines.engine-stats/1";
+
+struct six_sines_plugin_engine_stats
+{
+    // [thread-safe] Copies the counters as they stand
+    void(CLAP_ABI *get)(const clap_plugin_t *plugin,
+                        baconpaul::six_sines::EngineStats::Snapshot *into);
+
+    // [thread-safe] Zeroes the counters at the start of the next host block
+    void(CLAP_ABI *reset)(const clap_plugin_t *plugin);
+
+    // [main-thread] Writes the counters as text to path. Returns false if the file
+    // could not be written.
+    bool(CLAP_ABI *write_to_file)(const clap_plugin_t *plugin, const char *path);
+};
+
+#endif // BACONPAUL_SIX_SINES_CLAP_ENGINE_STATS_EXT_H
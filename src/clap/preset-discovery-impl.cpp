@@ -66,9 +66,11 @@ bool get_metadata(const struct clap_preset_discovery_provider *provider, uint32_
     if (location_kind == CLAP_PRESET_DISCOVERY_LOCATION_PLUGIN)
     {
         // factory content
+        auto snap = pm->pm.index->snapshot();
         int idx{0};
         for (auto &fac : pm->pm.factoryPatchVector)
         {
+            const auto &ent = snap->factory[idx];
             auto dName = fac.first + "/" + fac.second;
             auto sps = dName.find(".sxsnp");
             if (sps != std::string::npos)
@@ -89,12 +91,18 @@ bool get_metadata(const struct clap_preset_discovery_provider *provider, uint32_
             clap_universal_plugin_id_t clp{"clap", "org.baconpaul.six-sines"};
             mdr->add_plugin_id(mdr, &clp);
             mdr->set_description(mdr, desc.c_str());
+            if (!ent.author.empty())
+                mdr->add_creator(mdr, ent.author.c_str());
+            mdr->add_feature(mdr, ent.category.c_str());
         }
 
         return true;
     }
 
     fs::path p = fs::path{fs::u8path(location)};
+    // Name, author and category from the index, which only opens the file if it
+    // has changed since the index last saw it
+    auto ent = pm->pm.index->userEntryFor(p);
     p = p.replace_extension("");
     p = p.filename();
 
@@ -107,6 +115,13 @@ bool get_metadata(const struct clap_preset_discovery_provider *provider, uint32_
     clap_universal_plugin_id_t clp{"clap", "org.baconpaul.six-sines"};
     mdr->add_plugin_id(mdr, &clp);
     mdr->set_description(mdr, "A Six Sines User Preset");
+    if (ent.has_value())
+    {
+        if (!ent->author.empty())
+            mdr->add_creator(mdr, ent->author.c_str());
+        if (!ent->category.empty())
+            mdr->add_feature(mdr, ent->category.c_str());
+    }
 
     return true;
 }
@@ -19,6 +19,8 @@
 #include "clap/six-sines-clap-entry-impl.h"
 #include "clap/preset-discovery-impl.h"
 #include "clap/plugin.h"
+#include "dsp/sintable.h"
+#include "synth/matrix_index.h"
 #include "clapwrapper/vst3.h"
 #include "clapwrapper/auv2.h"
 
@@ -188,6 +190,10 @@ bool clap_init(const char *p)
     SXSNLOG("Initializing Six Sines "
             << sst::plugininfra::VersionInformation::project_version_and_hash << " / "
             << sst::plugininfra::VersionInformation::git_implied_display_version);
+
+    // Shared tables are built here, once, before any instance can race for them
+    MatrixIndex::initialize();
+    SinTable::initializeStatics();
     return true;
 }
 void clap_deinit() {}
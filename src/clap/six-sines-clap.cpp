@@ -15,7 +15,6 @@
 
 #include "configuration.h"
 #include <clap/clap.h>
-#include <chrono>
 
 #include <clap/helpers/plugin.hh>
 #include "synth/synth.h"
@@ -27,14 +26,19 @@
 #include <memory>
 #include "sst/plugininfra/patch-support/patch_base_clap_adapter.h"
 #include "sst/plugininfra/cpufeatures.h"
+#include "sst/plugininfra/paths.h"
 
 #include "sst/voicemanager/midi1_to_voicemanager.h"
 #include "sst/clap_juce_shim/clap_juce_shim.h"
 
 #include "ui/six-sines-editor.h"
+#include "ui/ui-defaults.h"
+#include "clap/engine-stats-ext.h"
 
 #include <clapwrapper/vst3.h>
 #include <clapwrapper/auv2.h>
+#include <fstream>
+#include <limits>
 #include <numeric>
 #include <algorithm>
 
@@ -69,7 +73,6 @@ struct SixSinesClap : public plugHelper_t, sst::clap_juce_shim::EditorProvider
     virtual ~SixSinesClap() {};
 
     std::unique_ptr<Synth> engine;
-    size_t blockPos{0};
 
     // Stable buffer so SET_DAW_EXTRA_STATE messages pushed from stateLoad remain valid
     // for the audio thread to pick up after stateLoad returns.
@@ -80,6 +83,16 @@ struct SixSinesClap : public plugHelper_t, sst::clap_juce_shim::EditorProvider
                   uint32_t maxFrameCount) noexcept override
     {
         engine->setSampleRate(sampleRate);
+        if ((int)std::round(engine->patch.output.eventTiming.value) == ET_SAMPLE_ACCURATE)
+            engine->prepareStartDelayLines();
+
+        // Render threads and the cpu budget are per-machine choices, so they come from
+        // the user defaults rather than the patch or session state.
+        auto defaults = ui::defaultsProvder_t(
+            sst::plugininfra::paths::bestDocumentsFolderPathFor("SixSines"), "SixSinesUI",
+            ui::defaultName, [](auto e, auto b) { SXSNLOG("[ERROR]" << e << " " << b); });
+        engine->setRenderThreads(defaults.getUserDefaultValue(ui::Defaults::renderThreads, 1));
+        engine->setCpuBudget(defaults.getUserDefaultValue(ui::Defaults::cpuBudget, 0) * 0.01f);
         return true;
     }
 
@@ -188,45 +201,25 @@ struct SixSinesClap : public plugHelper_t, sst::clap_juce_shim::EditorProvider
             audioInR = process->audio_inputs[0].data32[1];
         }
 
-        for (auto s = 0U; s < process->frames_count; ++s)
+        auto dispatchEvents = [&](uint32_t s)
         {
-            engine->pushAudioIn(audioInL ? audioInL[s] : 0.f, audioInR ? audioInR[s] : 0.f);
-
-            if (blockPos == 0)
+            while (nextEvent && nextEvent->time <= s)
             {
-                // Only realy need to run events when we do the block process
-                while (nextEvent && nextEvent->time <= s)
-                {
-                    handleEvent(nextEvent);
-                    nextEventIndex++;
-                    if (nextEventIndex < sz)
-                        nextEvent = ev->get(ev, nextEventIndex);
-                    else
-                        nextEvent = nullptr;
-                }
-
-                engine->process(outq);
+                handleEvent(nextEvent);
+                nextEventIndex++;
+                if (nextEventIndex < sz)
+                    nextEvent = ev->get(ev, nextEventIndex);
+                else
+                    nextEvent = nullptr;
             }
+            return nextEvent ? nextEvent->time : std::numeric_limits<uint32_t>::max();
+        };
 
-            for (auto i = 0; i < outChan; ++i)
-                out[i][s] = engine->output[i][blockPos];
-
-            blockPos++;
-            if (blockPos == blockSize)
-            {
-                blockPos = 0;
-            }
-        }
+        engine->processBlock(process->frames_count, out, audioInL, audioInR, outq,
+                             dispatchEvents);
 
-        while (nextEvent)
-        {
-            handleEvent(nextEvent);
-            nextEventIndex++;
-            if (nextEventIndex < sz)
-                nextEvent = ev->get(ev, nextEventIndex);
-            else
-                nextEvent = nullptr;
-        }
+        // Anything stamped after the last engine block boundary still applies
+        dispatchEvents(std::numeric_limits<uint32_t>::max());
         return CLAP_PROCESS_CONTINUE;
     }
 
@@ -266,8 +259,9 @@ struct SixSinesClap : public plugHelper_t, sst::clap_juce_shim::EditorProvider
             case CLAP_EVENT_PARAM_VALUE:
             {
                 auto pevt = reinterpret_cast<const clap_event_param_value *>(nextEvent);
-                auto par =
-                    sst::plugininfra::patch_support::paramFromClapEvent<Param>(pevt, engine->patch);
+                // paramsInfo hands out each Param as its cookie, so prefer that
+                auto par = pevt->cookie ? static_cast<Param *>(pevt->cookie)
+                                        : engine->patch.paramById(pevt->param_id);
                 if (par)
                 {
                     engine->handleParamValue(par, pevt->param_id, pevt->value);
@@ -295,27 +289,25 @@ struct SixSinesClap : public plugHelper_t, sst::clap_juce_shim::EditorProvider
     bool implementsState() const noexcept override { return true; }
     bool stateSave(const clap_ostream *ostream) noexcept override
     {
+        // The audio thread keeps a snapshot of the patch as it would be saved, so
+        // there is nothing to wait for; the message just marks the patch clean.
         engine->mainToAudio.push({Synth::MainToAudioMsg::SEND_PREP_FOR_STREAM});
         if (_host.canUseParams())
             _host.paramsRequestFlush();
 
-        // best efforts on that message for now
-        static constexpr int maxIts{5};
-        int i{0};
-        for (i = 0; i < maxIts && !engine->readyForStream; ++i)
-        {
-            using namespace std::chrono_literals;
-            std::this_thread::sleep_for(4ms);
-        }
-        if (i == maxIts && !engine->readyForStream)
+        // The compact binary form; stateLoad still takes the XML older versions wrote
+        auto state = engine->patchForStream().toBinaryState(true);
+        auto *d = state.data();
+        auto remaining = (int64_t)state.size();
+        while (remaining > 0)
         {
-            // sigh. something is wonky
-            engine->prepForStream();
+            auto written = ostream->write(ostream, d, remaining);
+            if (written <= 0)
+                return false;
+            d += written;
+            remaining -= written;
         }
-
-        auto res = sst::plugininfra::patch_support::patchToOutStream(engine->patch, ostream, true);
-        engine->readyForStream = false;
-        return res;
+        return true;
     }
     bool stateLoad(const clap_istream *istream) noexcept override
     {
@@ -324,7 +316,12 @@ struct SixSinesClap : public plugHelper_t, sst::clap_juce_shim::EditorProvider
         patchCopy->dawExtraStateFrom = [this](TiXmlElement &e)
         { Synth::fromDawExtraState(e, loadedDawExtraState); };
 
-        if (!sst::plugininfra::patch_support::inStreamToPatch(istream, *patchCopy))
+        std::string state;
+        char buffer[4096];
+        int64_t rd;
+        while ((rd = istream->read(istream, buffer, sizeof(buffer))) > 0)
+            state.append(buffer, rd);
+        if (rd < 0 || !patchCopy->fromAnyState(state))
             return false;
 
         presets::PresetManager::sendEntirePatchToAudio(*patchCopy, engine->mainToAudio,
@@ -414,14 +411,14 @@ struct SixSinesClap : public plugHelper_t, sst::clap_juce_shim::EditorProvider
                 auto p = fs::path(fs::u8path(location));
                 if (p.extension() == ".sxsnp")
                 {
-                    std::ifstream t(p);
+                    std::ifstream t(p, std::ios::binary);
                     if (!t.is_open())
                         return false;
                     std::stringstream buffer;
                     buffer << t.rdbuf();
 
                     auto patchCopy = std::make_unique<Patch>();
-                    patchCopy->fromState(buffer.str());
+                    patchCopy->fromAnyState(buffer.str());
 
                     auto dn = p.filename().replace_extension("").u8string();
                     presets::PresetManager::sendEntirePatchToAudio(*patchCopy, engine->mainToAudio,
@@ -553,6 +550,26 @@ struct SixSinesClap : public plugHelper_t, sst::clap_juce_shim::EditorProvider
         return true;
     }
 
+    static void CLAP_ABI stats_get(const clap_plugin_t *plugin, EngineStats::Snapshot *into)
+    {
+        auto *self = static_cast<SixSinesClap *>(plugin->plugin_data);
+        *into = self->engine->stats.read();
+    }
+    static void CLAP_ABI stats_reset(const clap_plugin_t *plugin)
+    {
+        auto *self = static_cast<SixSinesClap *>(plugin->plugin_data);
+        self->engine->stats.reset();
+    }
+    static bool CLAP_ABI stats_write_to_file(const clap_plugin_t *plugin, const char *path)
+    {
+        auto *self = static_cast<SixSinesClap *>(plugin->plugin_data);
+        std::ofstream ofs(path);
+        if (!ofs.is_open())
+            return false;
+        self->engine->stats.read().write(ofs);
+        return (bool)ofs;
+    }
+
     const void *extension(const char *id) noexcept override
     {
         if (strcmp(id, CLAP_PLUGIN_AS_VST3) == 0)
@@ -565,6 +582,12 @@ struct SixSinesClap : public plugHelper_t, sst::clap_juce_shim::EditorProvider
             static clap_plugin_auv2_param_ordering_t auv2po{auv2_get_param_order};
             return &auv2po;
         }
+        if (strcmp(id, SIX_SINES_EXT_ENGINE_STATS) == 0)
+        {
+            static six_sines_plugin_engine_stats stats{stats_get, stats_reset,
+                                                       stats_write_to_file};
+            return &stats;
+        }
 
         return nullptr;
     }
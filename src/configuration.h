@@ -26,8 +26,25 @@
 namespace baconpaul::six_sines
 {
 
-static constexpr size_t blockSize{8};
-static constexpr double blockSizeInv{1.0 / 8};
+// Build option SIX_SINES_BLOCK_SIZE. The engine updates envelopes, LFOs and
+// modulation once per block, so a larger block is cheaper to run but steps its
+// modulation more coarsely. Patches sound the same up to that; streamed state
+// doesn't depend on it.
+#ifndef SIX_SINES_BLOCK_SIZE
+#define SIX_SINES_BLOCK_SIZE 8
+#endif
+static constexpr size_t blockSize{SIX_SINES_BLOCK_SIZE};
+static constexpr double blockSizeInv{1.0 / blockSize};
+static_assert(blockSize == 8 || blockSize == 16 || blockSize == 32,
+              "SIX_SINES_BLOCK_SIZE must be 8, 16 or 32");
+
+// Build option SIX_SINES_BATCHED_TABLE_LOOKUP. When on, operators with no self
+// feedback compute their phases for a whole block then look them all up at once
+// with SinTable::atBlock, rather than one SinTable::at per sample.
+#ifndef SIX_SINES_BATCHED_TABLE_LOOKUP
+#define SIX_SINES_BATCHED_TABLE_LOOKUP 1
+#endif
+static constexpr bool batchedTableLookup{SIX_SINES_BATCHED_TABLE_LOOKUP != 0};
 
 static constexpr size_t numOps{6};
 static constexpr size_t matrixSize{(numOps * (numOps - 1)) / 2};
@@ -59,7 +76,8 @@ enum ResamplerEngine
     SRC_BEST,
     LANCZOS,
     LINTERP,
-    ZOH
+    ZOH,
+    INT_DECIMATE // IntegerDecimator when engine / host is whole, SRC Fast otherwise
 };
 
 // Output signal-path stage settings (streamed)
@@ -110,6 +128,18 @@ enum HighpassMode
     HP_50HZ = 3
 };
 
+enum EventTiming
+{
+    ET_BLOCK = 0,
+    ET_SAMPLE_ACCURATE = 1
+};
+
+enum OpRenderRate
+{
+    ORR_FULL = 0,
+    ORR_ADAPTIVE = 1 // OpSource looks up half its samples when its bandwidth is low
+};
+
 } // namespace baconpaul::six_sines
 
 inline std::string fileTrunc(const std::string &f)
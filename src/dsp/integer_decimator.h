@@ -0,0 +1,204 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#ifndef BACONPAUL_SIX_SINES_DSP_INTEGER_DECIMATOR_H
+#define BACONPAUL_SIX_SINES_DSP_INTEGER_DECIMATOR_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "configuration.h"
+#include <sst/basic-blocks/simd/setup.h>
+
+namespace baconpaul::six_sines
+{
+/*
+ * Decimation by a whole number, for when the engine rate is an exact multiple of
+ * the host rate (192k to 96k or 48k, 240k to 48k, 144k to 48k and so on).
+ *
+ * The factor is split into half-band stages for its twos followed by one
+ * windowed-sinc stage for what is left (3, 5 or 7). Each stage only computes the
+ * samples it keeps, and a half-band's every other tap is zero and skipped, so
+ * this does a small fraction of the work of a general ratio resampler. Every
+ * stage's cutoff sits at its output Nyquist with the transition running from 0.4
+ * to 0.6 of its output rate, so nothing aliases below 0.4 of the host rate.
+ *
+ * Like PolyphaseDecimator, channels are carried four to a SIMD register.
+ */
+template <size_t maxChannels> struct IntegerDecimator
+{
+    static constexpr size_t maxGroups{(maxChannels + 3) / 4};
+    static constexpr int maxFactor{8}, maxStages{3}, tapsPerFactor{28};
+    static constexpr int maxTaps{tapsPerFactor * 7 + 1};
+    static constexpr int64_t ringSize{256}, ringMask{ringSize - 1};
+    static constexpr int64_t fifoSize{4 * blockSize}, fifoMask{fifoSize - 1};
+    static_assert(ringSize >= maxTaps);
+
+    struct Stage
+    {
+        int factor{1}, phase{0};
+        int nTaps{0}; // the non-zero ones
+        int offset[maxTaps]{};
+        float coef[maxTaps]{};
+        int64_t written{0};
+        SIMD_M128 ring alignas(16)[ringSize][maxGroups];
+    };
+    Stage stages[maxStages];
+    int nStages{0};
+
+    SIMD_M128 fifo alignas(16)[fifoSize][maxGroups];
+    int64_t fifoWrite{0}, fifoRead{0};
+
+    size_t channels{2}, groups{1};
+
+    bool setRates(int64_t engineRate, int64_t hostRate, size_t nChannels)
+    {
+        if (engineRate <= 0 || hostRate <= 0 || nChannels > maxChannels ||
+            engineRate % hostRate != 0)
+            return false;
+        auto factor = (int)(engineRate / hostRate);
+        if (factor > maxFactor)
+            return false;
+
+        channels = nChannels;
+        groups = (channels + 3) / 4;
+
+        nStages = 0;
+        while (factor % 2 == 0)
+        {
+            design(stages[nStages++], 2);
+            factor /= 2;
+        }
+        if (factor > 1)
+            design(stages[nStages++], factor);
+
+        reset();
+        return true;
+    }
+
+    void reset()
+    {
+        for (auto &s : stages)
+        {
+            memset(s.ring, 0, sizeof(s.ring));
+            s.written = 0;
+            s.phase = 0;
+        }
+        fifoWrite = 0;
+        fifoRead = 0;
+    }
+
+    // One engine block of every channel, laid out as in[channel][sample]
+    void push(const float in[][blockSize])
+    {
+        for (int i = 0; i < blockSize; ++i)
+        {
+            float lanes alignas(16)[maxGroups * 4]{};
+            for (size_t c = 0; c < channels; ++c)
+                lanes[c] = in[c][i];
+            SIMD_M128 frame[maxGroups];
+            for (size_t g = 0; g < groups; ++g)
+                frame[g] = SIMD_MM(load_ps)(lanes + 4 * g);
+
+            int s{0};
+            while (s < nStages && step(stages[s], frame))
+                s++;
+            if (s == nStages)
+            {
+                auto *f = fifo[fifoWrite & fifoMask];
+                for (size_t g = 0; g < groups; ++g)
+                    f[g] = frame[g];
+                fifoWrite++;
+            }
+        }
+    }
+
+    bool canProduce(int n) const { return fifoWrite - fifoRead >= n; }
+
+    // n output frames of every channel, to out[channel] + offset
+    void produce(float *const *out, int n, int offset = 0)
+    {
+        for (int o = 0; o < n; ++o)
+        {
+            const auto *f = fifo[fifoRead & fifoMask];
+            float res alignas(16)[maxGroups * 4];
+            for (size_t g = 0; g < groups; ++g)
+                SIMD_MM(store_ps)(res + 4 * g, f[g]);
+            for (size_t ch = 0; ch < channels; ++ch)
+                out[ch][offset + o] = res[ch];
+            fifoRead++;
+        }
+    }
+
+  private:
+    // Takes one frame in; when the stage has a sample to keep, replaces the frame
+    // with it and returns true
+    bool step(Stage &st, SIMD_M128 *frame)
+    {
+        auto *slot = st.ring[st.written & ringMask];
+        for (size_t g = 0; g < groups; ++g)
+            slot[g] = frame[g];
+        st.written++;
+
+        if (++st.phase < st.factor)
+            return false;
+        st.phase = 0;
+
+        for (size_t g = 0; g < groups; ++g)
+            frame[g] = SIMD_MM(setzero_ps)();
+        for (int k = 0; k < st.nTaps; ++k)
+        {
+            const auto *src = st.ring[(st.written - 1 - st.offset[k]) & ringMask];
+            auto ck = SIMD_MM(set1_ps)(st.coef[k]);
+            for (size_t g = 0; g < groups; ++g)
+                frame[g] = SIMD_MM(add_ps)(frame[g], SIMD_MM(mul_ps)(src[g], ck));
+        }
+        return true;
+    }
+
+    static void design(Stage &st, int factor)
+    {
+        // Blackman windowed sinc; the window's transition band is about 5.5 / n
+        // of the input rate, which at this length is 0.2 of the output rate
+        int n = tapsPerFactor * factor + 1;
+        double fc = 0.5 / factor, center = (n - 1) / 2.0;
+        double h[maxTaps], sum{0};
+        for (int i = 0; i < n; ++i)
+        {
+            auto x = i - center;
+            auto px = 2 * M_PI * fc * x;
+            auto sinc = std::fabs(x) < 1e-9 ? 1.0 : std::sin(px) / px;
+            auto w = 0.42 - 0.5 * std::cos(2 * M_PI * i / (n - 1)) +
+                     0.08 * std::cos(4 * M_PI * i / (n - 1));
+            h[i] = sinc * w;
+            sum += h[i];
+        }
+
+        st.factor = factor;
+        st.nTaps = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            // A half-band's taps at even distances from the center are zero
+            if (std::fabs(h[i] / sum) < 1e-9)
+                continue;
+            st.offset[st.nTaps] = i;
+            st.coef[st.nTaps] = (float)(h[i] / sum);
+            st.nTaps++;
+        }
+    }
+};
+} // namespace baconpaul::six_sines
+#endif // BACONPAUL_SIX_SINES_DSP_INTEGER_DECIMATOR_H
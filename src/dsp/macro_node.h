@@ -51,7 +51,7 @@ struct MacroVoiceNode : EnvelopeSupport<Patch::MacroNode>,
     MacroVoiceNode(const Patch::MacroNode &mn, MonoValues &mv, const VoiceValues &vv)
         : macroNode(mn), monoValues(mv), voiceValues(vv), level(mn.level),
           macroPowerV(mn.macroPower), envDepth(mn.envDepth), lfoDepth(mn.lfoDepth),
-          ModulationSupport(mn, this, mv, vv), EnvelopeSupport(mn, mv, vv), LFOSupport(mn, mv)
+          ModulationSupport(mn, this, mv, vv), EnvelopeSupport(mn, mv, vv), LFOSupport(mn, mv, vv)
     {
     }
 
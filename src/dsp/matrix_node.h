@@ -44,17 +44,27 @@ struct MatrixNodeFrom : public EnvelopeSupport<Patch::MatrixNode>,
                    const VoiceValues &vv)
         : matrixNode(mn), monoValues(mv), voiceValues(vv), onto(on), from(fr), level(mn.level),
           modmodeV(mn.modulationMode), activeV(mn.active), EnvelopeSupport(mn, mv, vv),
-          LFOSupport(mn, mv), lfoToDepth(mn.lfoToDepth), envToLevel(mn.envToLevel),
+          LFOSupport(mn, mv, vv), lfoToDepth(mn.lfoToDepth), envToLevel(mn.envToLevel),
           overdriveV(mn.overdrive), ModulationSupport(mn, this, mv, vv),
           rmScaleV(mn.modulationScale)
     {
     }
 
     bool active{false};
+    // Set by Voice::rebuildRouting; false when this edge can't reach the output
+    bool live{true};
     int modMode{0};
     int rmScale{0};
     float overdriveFactor{1.0};
 
+    // Whether applyBlock can change its target at all. With no level, no lfo depth,
+    // no additive env and nothing modulating the node, modlev is zero every sample.
+    bool contributes() const
+    {
+        return active && (level != 0 || lfoToDepth != 0 || (!envIsMult && envToLevel != 0) ||
+                          anySources);
+    }
+
     void attack()
     {
         resetModulation();
@@ -87,6 +97,12 @@ struct MatrixNodeFrom : public EnvelopeSupport<Patch::MatrixNode>,
         calculateModulation();
         envProcess();
         lfoProcess();
+
+        // A dead edge keeps its envelope and lfo in time, since its level can be
+        // modulated back up mid-note, but has nothing to write
+        if (!live)
+            return;
+
         float modlev alignas(16)[blockSize];
 
         // Construct the level which is lfo * lev + env * lev or + env * dept + lev
@@ -96,12 +112,6 @@ struct MatrixNodeFrom : public EnvelopeSupport<Patch::MatrixNode>,
         }
 
         auto l2d = lfoToDepth * lfoAtten;
-        static float la{-1111};
-        if (la != lfoAtten)
-        {
-            la = lfoAtten;
-        }
-
         if (envIsMult)
         {
             auto e2d = level * depthAtten;
@@ -253,7 +263,7 @@ struct MatrixNodeSelf : EnvelopeSupport<Patch::SelfNode>,
     MatrixNodeSelf(const Patch::SelfNode &sn, OpSource &on, MonoValues &mv, const VoiceValues &vv)
         : selfNode(sn), monoValues(mv), voiceValues(vv), onto(on), fbBase(sn.fbLevel),
           lfoToFB(sn.lfoToFB), activeV(sn.active), envToFB(sn.envToFB), overdriveV(sn.overdrive),
-          EnvelopeSupport(sn, mv, vv), LFOSupport(sn, mv), ModulationSupport(sn, this, mv, vv) {};
+          EnvelopeSupport(sn, mv, vv), LFOSupport(sn, mv, vv), ModulationSupport(sn, this, mv, vv) {};
     bool active{true}, lfoMul{false};
     float overdriveFactor{1.0};
 
@@ -389,11 +399,12 @@ struct MixerNode : EnvelopeSupport<Patch::MixerNode>,
 
     const float &level, &activeF, &pan, &lfoToLevel, &lfoToPan, &envToLevel;
     bool active{false};
+    bool live{true}; // see Voice::rebuildRouting
 
     MixerNode(const Patch::MixerNode &mn, OpSource &f, MonoValues &mv, const VoiceValues &vv)
         : mixerNode(mn), monoValues(mv), voiceValues(vv), from(f), pan(mn.pan), level(mn.level),
           activeF(mn.active), lfoToLevel(mn.lfoToLevel), lfoToPan(mn.lfoToPan),
-          envToLevel(mn.envToLevel), EnvelopeSupport(mn, mv, vv), LFOSupport(mn, mv),
+          envToLevel(mn.envToLevel), EnvelopeSupport(mn, mv, vv), LFOSupport(mn, mv, vv),
           ModulationSupport(mn, this, mv, vv)
     {
         memset(output, 0, sizeof(output));
@@ -438,6 +449,14 @@ struct MixerNode : EnvelopeSupport<Patch::MixerNode>,
         return used;
     }
 
+    // Whether anything this node writes can be heard, on the same terms as
+    // MatrixNodeFrom::contributes plus solo.
+    bool reachesOutput() const
+    {
+        return active && !mixerNode.isMutedDueToSoloAway &&
+               (level != 0 || lfoToLevel != 0 || (!envIsMult && envToLevel != 0) || anySources);
+    }
+
     void renderBlock()
     {
         if (!active)
@@ -452,6 +471,10 @@ struct MixerNode : EnvelopeSupport<Patch::MixerNode>,
 
         lfoProcess();
 
+        // As MatrixNodeFrom::applyBlock; Voice::rebuildRouting zeroed our output
+        if (!live)
+            return;
+
         float dcValues alignas(16)[blockSize];
         float *useOut;
         if (from.rmAssigned || doBlock)
@@ -602,7 +625,7 @@ struct MainPanNode : EnvelopeSupport<Patch::MainPanNode>,
     const float &lfoD, &envD;
 
     MainPanNode(const Patch::MainPanNode &mn, MonoValues &mv, const VoiceValues &vv)
-        : ModulationSupport(mn, this, mv, vv), EnvelopeSupport(mn, mv, vv), LFOSupport(mn, mv),
+        : ModulationSupport(mn, this, mv, vv), EnvelopeSupport(mn, mv, vv), LFOSupport(mn, mv, vv),
           modNode(mn), monoValues(mv), voiceValues(vv), lfoD(mn.lfoDepth), envD(mn.envDepth)
     {
     }
@@ -742,7 +765,7 @@ struct FineTuneNode : EnvelopeSupport<Patch::FineTuneNode>,
     const float &lfoD, &envD, &coarseTune, &lfoCoarseD, &envCoarseD;
 
     FineTuneNode(const Patch::FineTuneNode &mn, MonoValues &mv, const VoiceValues &vv)
-        : ModulationSupport(mn, this, mv, vv), EnvelopeSupport(mn, mv, vv), LFOSupport(mn, mv),
+        : ModulationSupport(mn, this, mv, vv), EnvelopeSupport(mn, mv, vv), LFOSupport(mn, mv, vv),
           coarseTune(mn.coarseTune), modNode(mn), monoValues(mv), voiceValues(vv),
           lfoD(mn.lfoDepth), envD(mn.envDepth), lfoCoarseD(mn.lfoCoarseDepth),
           envCoarseD(mn.envCoarseDepth)
@@ -905,7 +928,7 @@ struct OutputNode : EnvelopeSupport<Patch::OutputNode>,
         : outputNode(on), ModulationSupport(on, this, mv, vv), monoValues(mv), voiceValues(vv),
           fromArr(f), level(on.level), bendUp(on.bendUp), bendDown(on.bendDown),
           octTranspose(on.octTranspose), velSen(on.velSensitivity), EnvelopeSupport(on, mv, vv),
-          LFOSupport(on, mv), defTrigV(on.defaultTrigger), pan(on.pan), fineTune(on.fineTune),
+          LFOSupport(on, mv, vv), defTrigV(on.defaultTrigger), pan(on.pan), fineTune(on.fineTune),
           lfoDepth(on.lfoDepth), ftModNode(ftMN, mv, vv), panModNode(panMN, mv, vv)
     {
         memset(output, 0, sizeof(output));
@@ -930,6 +953,14 @@ struct OutputNode : EnvelopeSupport<Patch::OutputNode>,
     }
 
     float finalEnvLevel alignas(16)[blockSize];
+
+    // Each mixer's contribution at output level, for the multi-out buses and the
+    // op VU meters, so the synth sums these rather than multiplying per voice.
+    // Only filled while MonoValues::renderOpOutputs is set; bit i of opOutputMask
+    // says opOutput[i] was written this block.
+    float opOutput alignas(16)[numOps][2][blockSize];
+    uint32_t opOutputMask{0};
+
     void renderBlock()
     {
         calculateModulation();
@@ -965,6 +996,20 @@ struct OutputNode : EnvelopeSupport<Patch::OutputNode>,
         lv = 0.15 * std::clamp(v * lv * lv * lv, 0.f, 1.f);
         mech::scale_by<blockSize>(lv, finalEnvLevel);
 
+        opOutputMask = 0;
+        if (monoValues.renderOpOutputs)
+        {
+            for (int i = 0; i < numOps; ++i)
+            {
+                const auto &from = fromArr[i];
+                if (!from.active || !from.live)
+                    continue;
+                mech::mul_block<blockSize>(finalEnvLevel, from.output[0], opOutput[i][0]);
+                mech::mul_block<blockSize>(finalEnvLevel, from.output[1], opOutput[i][1]);
+                opOutputMask |= 1u << i;
+            }
+        }
+
         mech::scale_by<blockSize>(finalEnvLevel, output[0], output[1]);
 
         auto pn = std::clamp(panMod + pan + panModNode.level + voiceValues.noteExpressionPanBipolar,
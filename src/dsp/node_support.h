@@ -78,6 +78,10 @@ template <typename T> struct EnvelopeSupport
     bool releaseEnvStarted{false}, releaseEnvUngated{false};
     bool envIsMult{true};
 
+    // Set when the last block sat flat at sustain; see envProcess
+    bool envHeld{false};
+    float heldSustainIn{0.f};
+
     static constexpr float minAttackOnRetrig{0.05}; // the main dahdsr default
     float minAttack{0.f};
     bool retriggerHasFloor{true};
@@ -105,6 +109,7 @@ template <typename T> struct EnvelopeSupport
             constantEnv = false;
         }
 
+        envHeld = false;
         bool running = env.stage <= env_t::s_release;
 
         float startingValue = 0.f;
@@ -204,16 +209,29 @@ template <typename T> struct EnvelopeSupport
                 memset(env.outputCache, 0, sizeof(env.outputCache));
                 env.output = 0;
                 env.outBlock0 = 0;
+                envHeld = false;
                 return;
             }
 
             auto gate = envIsOneShot ? env.stage < env_t::s_sustain : voiceValues.gated;
+            auto sustainIn = sustain + sustainMod;
+
+            // A gated envelope resting on an unmoving sustain produces the same block
+            // it did last time, which is the common case for a held note, so leave
+            // the output where it is rather than recompute it.
+            if (envHeld && gate && env.stage == env_t::s_sustain && sustainIn == heldSustainIn &&
+                monoValues.reuseHeldBlocks)
+                return;
+
+            auto priorOutput = env.output;
             env.processBlockWithDelay(std::clamp(delay + delayMod, 0.f, 1.f),
                                       std::clamp(attackv + attackMod, minAttack, 1.f),
                                       std::clamp(hold + holdMod, 0.f, 1.f),
                                       std::clamp(decay + decayMod, 0.f, 1.f), sustain + sustainMod,
                                       std::clamp(release + releaseMod, 0.f, 1.f), ash, dsh, rsh,
                                       gate, needsCurve);
+            envHeld = gate && env.stage == env_t::s_sustain && env.output == priorOutput;
+            heldSustainIn = sustainIn;
         }
     }
 
@@ -261,10 +279,27 @@ template <typename T> struct EnvelopeSupport
     }
 };
 
+/*
+ * The step sequencer's state (the StepLFO, its transport and a copy of the steps)
+ * outweighs the rest of an LFO and only a Step shape touches it, so it lives apart
+ * from the nodes. Each voice holds every node's in one contiguous block
+ * (Voice::StepStates) and points LFOSupport::step into it, which keeps the nodes'
+ * per-block fields together rather than spread around it.
+ */
+struct StepLFOState
+{
+    using lfo_t = sst::basic_blocks::modulators::StepLFO<blockSize>;
+    explicit StepLFOState(MonoValues &mv) : lfo(mv.tuningProvider) {}
+    lfo_t lfo;
+    lfo_t::Storage storage;
+    sst::basic_blocks::modulators::Transport transport;
+};
+
 template <typename Parent, typename T, bool needsSmoothing = true> struct LFOSupport
 {
     const T &paramBundle;
-    MonoValues &monoValues; // non-const so we can read the RNG
+    MonoValues &monoValues;
+    sst::basic_blocks::dsp::RNG &voiceRng; // per voice so voices can render concurrently
 
     const float &lfoRate, &lfoDeform, &lfoShape, &lfoActiveV, &tempoSyncV, &bipolarV,
         &lfoIsEnvelopedV, &lfoStartPhase;
@@ -273,36 +308,38 @@ template <typename Parent, typename T, bool needsSmoothing = true> struct LFOSup
     lfo_t lfo;
     sst::basic_blocks::dsp::OnePoleLag<float, false> lag;
 
-    using stepLfo_t = sst::basic_blocks::modulators::StepLFO<blockSize>;
-    stepLfo_t stepLFO;
-    typename stepLfo_t::Storage stepStorage;
-    sst::basic_blocks::modulators::Transport stepTransport;
-    std::array<const float *, numSeqSteps> stepValues;
-    const float *stepCountValue{nullptr};
-    const float *stepCycleModeValue{nullptr};
+    // Set by the owning Voice to this node's slot in its step state block
+    using stepLfo_t = StepLFOState::lfo_t;
+    StepLFOState *step{nullptr};
 
-    LFOSupport(const T &mn, MonoValues &mv)
-        : paramBundle(mn), lfo(&mv.sr, mv.rng), stepLFO(mv.tuningProvider), lfoRate(mn.lfoRate),
+    LFOSupport(const T &mn, MonoValues &mv, const VoiceValues &vv)
+        : paramBundle(mn), lfo(&mv.sr, vv.rng), voiceRng(vv.rng), lfoRate(mn.lfoRate),
           lfoDeform(mn.lfoDeform), lfoShape(mn.lfoShape), lfoActiveV(mn.lfoActive),
           tempoSyncV(mn.tempoSync), monoValues(mv), bipolarV(mn.lfoBipolar),
-          lfoIsEnvelopedV(mn.lfoIsEnveloped), lfoStartPhase(mn.lfoStartPhase),
-          stepValues(sst::cpputils::make_array_lambda<const float *, numSeqSteps>(
-              [&mn](int i) { return &mn.lfoSeqSteps[i].value; })),
-          stepCountValue(&mn.lfoStepCount.value), stepCycleModeValue(&mn.lfoCycleMode.value)
+          lfoIsEnvelopedV(mn.lfoIsEnveloped), lfoStartPhase(mn.lfoStartPhase)
     {
     }
 
+    // The steps only move when a param does, so the copy is redone when
+    // monoValues.paramSetVersion has moved since the last one. Smooth follows the
+    // deform modulation and is refreshed every block regardless.
+    uint32_t stepParamVersion{0};
+
     void snapStepStorageFromParams()
     {
-        for (size_t i = 0; i < numSeqSteps; ++i)
-            stepStorage.data[i] = *stepValues[i];
-        for (size_t i = numSeqSteps; i < stepLfo_t::Storage::stepLfoSteps; ++i)
-            stepStorage.data[i] = 0.f;
-        auto count = (int)std::round(*stepCountValue);
-        stepStorage.repeat = (int16_t)std::clamp(count, 1, (int)numSeqSteps);
-        auto cycleOn = stepCycleModeValue && *stepCycleModeValue > 0.5f;
-        stepStorage.rateIsForSingleStep = !cycleOn;
-        stepStorage.smooth = std::clamp(lfoDeform + lfoDeformMod, -1.f, 1.f);
+        auto &st = step->storage;
+        if (stepParamVersion != monoValues.paramSetVersion || !monoValues.reuseHeldBlocks)
+        {
+            for (size_t i = 0; i < numSeqSteps; ++i)
+                st.data[i] = paramBundle.lfoSeqSteps[i].value;
+            for (size_t i = numSeqSteps; i < stepLfo_t::Storage::stepLfoSteps; ++i)
+                st.data[i] = 0.f;
+            auto count = (int)std::round(paramBundle.lfoStepCount.value);
+            st.repeat = (int16_t)std::clamp(count, 1, (int)numSeqSteps);
+            st.rateIsForSingleStep = !(paramBundle.lfoCycleMode.value > 0.5f);
+            stepParamVersion = monoValues.paramSetVersion;
+        }
+        st.smooth = std::clamp(lfoDeform + lfoDeformMod, -1.f, 1.f);
     }
 
     float lfoRateMod{0.f}, lfoDeformMod{0.f}, lfoStartMod{0.f};
@@ -312,13 +349,15 @@ template <typename Parent, typename T, bool needsSmoothing = true> struct LFOSup
     bool bipolar{true};
     bool lfoIsEnveloped{false};
 
+    // checkLfoUsed reads only params and the routing fixed at attack, so an idle
+    // LFO asks again only once monoValues.paramSetVersion moves.
     bool runLfo{false};
-    int32_t runLfoCheck{0};
+    uint32_t runLfoVersion{0};
 
     void lfoAttack()
     {
         runLfo = static_cast<Parent *>(this)->checkLfoUsed();
-        runLfoCheck = 0;
+        runLfoVersion = monoValues.paramSetVersion;
 
         tempoSync = tempoSyncV > 0.5;
         bipolar = bipolarV > 0.5;
@@ -330,17 +369,18 @@ template <typename Parent, typename T, bool needsSmoothing = true> struct LFOSup
         // between attack and process, both branches must be reconciled.
         if (shape == Patch::LFOMixin::Shape::Step)
         {
+            stepParamVersion = monoValues.paramSetVersion - 1;
             snapStepStorageFromParams();
-            stepLFO.setSampleRate(monoValues.sr.sampleRate, monoValues.sr.sampleRateInv);
-            stepTransport.tempo = monoValues.tempoSyncRatio * 120.0;
+            step->lfo.setSampleRate(monoValues.sr.sampleRate, monoValues.sr.sampleRateInv);
+            step->transport.tempo = monoValues.tempoSyncRatio * 120.0;
             auto useRate = std::clamp(lfoRate + lfoRateMod, paramBundle.lfoRate.meta.minVal,
                                       paramBundle.lfoRate.meta.maxVal);
-            stepLFO.assign(&stepStorage, useRate, &stepTransport, monoValues.rng, tempoSync);
+            step->lfo.assign(&step->storage, useRate, &step->transport, voiceRng, tempoSync);
 
             double phase0 =
-                std::clamp(lfoStartPhase + lfoStartMod, 0.f, 0.999f) * stepStorage.repeat;
+                std::clamp(lfoStartPhase + lfoStartMod, 0.f, 0.999f) * step->storage.repeat;
             double phaseFr = phase0 - std::floor(phase0);
-            stepLFO.setPhaseTo((int)std::floor(phase0), (float)phaseFr);
+            step->lfo.setPhaseTo((int)std::floor(phase0), (float)phaseFr);
         }
         else
         {
@@ -376,13 +416,12 @@ template <typename Parent, typename T, bool needsSmoothing = true> struct LFOSup
     {
         if (!runLfo)
         {
-            if (runLfoCheck++ == 64)
-            {
-                runLfoCheck = 0;
-                runLfo = static_cast<Parent *>(this)->checkLfoUsed();
-            }
-
-            return;
+            if (runLfoVersion == monoValues.paramSetVersion)
+                return;
+            runLfoVersion = monoValues.paramSetVersion;
+            runLfo = static_cast<Parent *>(this)->checkLfoUsed();
+            if (!runLfo)
+                return;
         }
 
         auto rate = lfoRate;
@@ -395,12 +434,12 @@ template <typename Parent, typename T, bool needsSmoothing = true> struct LFOSup
         if (shape == Patch::LFOMixin::Shape::Step)
         {
             snapStepStorageFromParams();
-            stepTransport.tempo = monoValues.tempoSyncRatio * 120.0;
+            step->transport.tempo = monoValues.tempoSyncRatio * 120.0;
             auto useRate = std::clamp(rate + lfoRateMod, paramBundle.lfoRate.meta.minVal,
                                       paramBundle.lfoRate.meta.maxVal);
-            stepLFO.process(useRate, 0, tempoSync, false, blockSize);
+            step->lfo.process(useRate, 0, tempoSync, false, blockSize);
             for (int j = 0; j < blockSize; ++j)
-                lfo.outputBlock[j] = stepLFO.output;
+                lfo.outputBlock[j] = step->lfo.output;
         }
         else
         {
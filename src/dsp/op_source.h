@@ -51,6 +51,21 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
 
     float output alignas(16)[blockSize];
 
+    /*
+     * Adaptive render rate (ORR_ADAPTIVE, set per block by Voice::prepareOp). The
+     * no feedback sine path estimates its output bandwidth in cycles per sample as
+     * its largest phase step in the block, which covers the carrier and any FM or
+     * PM deviation, plus modBandwidth, which Voice::prepareOp works out from the
+     * estimates of the ops feeding it. Below reducedRateBandwidth it looks up only
+     * half the block; see lookupReduced. Every other path leaves bandwidth at
+     * Nyquist, so nothing it modulates reduces either.
+     */
+    static constexpr float reducedRateBandwidth{0.03f};
+    bool adaptiveRate{false};
+    float modBandwidth{0.f}, bandwidth{0.5f};
+    // outputContinues: output[] still ends with the sample before this block
+    bool outputContinues{false}, outputRendered{false};
+
     const Patch::SourceNode &sourceNode;
     MonoValues &monoValues;
     const VoiceValues &voiceValues;
@@ -136,13 +151,13 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
 
     OpSource(const Patch::SourceNode &sn, MonoValues &mv, const VoiceValues &vv)
         : sourceNode(sn), monoValues(mv), voiceValues(vv), EnvelopeSupport(sn, mv, vv),
-          LFOSupport(sn, mv), ModulationSupport(sn, this, mv, vv), ratio(sn.ratio),
+          LFOSupport(sn, mv, vv), ModulationSupport(sn, this, mv, vv), ratio(sn.ratio),
           activeV(sn.active), envToRatio(sn.envToRatio), lfoToRatio(sn.lfoToRatio),
           waveForm(sn.waveForm), kt(sn.keyTrack), ktv(sn.keyTrackValue),
           ktlo(sn.keyTrackValueIsLow), ktlov(sn.keyTrackLowFrequencyValue),
           startPhase(sn.startingPhase), octTranspose(sn.octTranspose),
           lfoToRatioFine(sn.lfoToRatioFine), envToRatioFine(sn.envToRatioFine),
-          noiseHelper(mv.rng, mv.dbToLinear)
+          noiseHelper(vv.rng, mv.dbToLinear)
     {
         reset();
     }
@@ -171,15 +186,16 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
             switch (resonantSweepWindowCachedAtAttack)
             {
             case RW::BLACKMAN_HARRIS:
-                stWindow.setWaveForm(SinTable::BLACKMAN_HARRIS_WINDOW);
+                windowWaveForm = SinTable::BLACKMAN_HARRIS_WINDOW;
                 break;
             case RW::TUKEY:
-                stWindow.setWaveForm(SinTable::TUKEY_WINDOW);
+                windowWaveForm = SinTable::TUKEY_WINDOW;
                 break;
             default:
-                stWindow.setWaveForm(SinTable::HANN_WINDOW);
+                windowWaveForm = SinTable::HANN_WINDOW;
                 break;
             }
+            windowTablePending = !stWindow.setWaveForm(windowWaveForm, SinTable::HANN_WINDOW);
         }
         firstTime = true;
         extendedMPrior = sourceNode.extendedModeM.value;
@@ -205,6 +221,8 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
         noisePos = 16;
         zeroInputs();
         snapActive();
+        outputRendered = false;
+        tablePending = false;
 
         if (active)
         {
@@ -217,7 +235,7 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
             resetPhaseOnly();
             fbVal[0] = 0.f;
             fbVal[1] = 0.f;
-            st.setWaveForm(waveFormCachedAtAttack);
+            tablePending = !st.setWaveForm(waveFormCachedAtAttack);
 
             if (lfoIsEnveloped)
             {
@@ -302,7 +320,11 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
         hasActiveFeedback = false;
     }
 
-    void clearOutputs() { memset(output, 0, sizeof(output)); }
+    void clearOutputs()
+    {
+        memset(output, 0, sizeof(output));
+        outputRendered = false;
+    }
 
     void snapActive() { active = activeV > 0.5 || monoValues.designModeRunAll; }
 
@@ -342,12 +364,81 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
     bool firstTime{true};
     void renderBlock()
     {
+        float rf, dRF;
+        if (!beginBlock(rf, dRF))
+            return;
+
+        if (softResetPhaseCount > 0)
+        {
+            float newOutput alignas(16)[blockSize];
+            innerLoop(output, fbVal, rf, dRF, phase);
+            innerLoop(newOutput, softFb, rf, dRF, softPhase);
+            float p0 = 1.f * softResetPhaseCount / softPhaseCount;
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                auto fac = p0 - i * dSoftPhase;
+                output[i] = fac * output[i] + (1 - fac) * newOutput[i];
+            }
+            softResetPhaseCount--;
+
+            if (softResetPhaseCount == 0)
+            {
+                phase = softPhase;
+                fbVal[0] = softFb[0];
+                fbVal[1] = softFb[1];
+            }
+        }
+        else
+        {
+            innerLoop(output, fbVal, rf, dRF, phase);
+        }
+    }
+
+    /*
+     * For an op nothing can hear this block (see Voice::rebuildRouting). Runs the
+     * modulation, env, lfo and ratio ramp and moves the phase on as renderBlock
+     * would with no FM coming in, but makes no table lookups, so an op whose level
+     * is modulated back up mid-note comes in at the right envelope stage and phase.
+     * Its feedback history starts again from zero, as at attack.
+     */
+    void advanceBlock()
+    {
+        float rf, dRF;
+        if (!beginBlock(rf, dRF))
+            return;
+
+        uint32_t ph alignas(16)[blockSize];
+        if (softResetPhaseCount > 0)
+        {
+            auto softRF = rf;
+            blockPhases(softRF, dRF, softPhase, ph);
+            if (--softResetPhaseCount == 0)
+                phase = softPhase;
+        }
+        blockPhases(rf, dRF, phase, ph);
+
+        memset(output, 0, sizeof(output));
+        fbVal[0] = fbVal[1] = 0.f;
+        softFb[0] = softFb[1] = 0.f;
+        outputRendered = false;
+    }
+
+    /*
+     * The per-block setup half of renderBlock: modulation, env, lfo and the ratio ramp.
+     * Returns false if the block was fully handled here (inactive or audio in) and
+     * there is no inner loop to run.
+     */
+    bool beginBlock(float &rf, float &dRF)
+    {
+        bandwidth = 0.5f;
         if (!active)
         {
             memset(output, 0, sizeof(output));
             fbVal[0] = 0.f;
             fbVal[1] = 0.f;
-            return;
+            outputRendered = false;
+            return false;
         }
 
         if (isAudioInCachedAtAttack)
@@ -362,9 +453,13 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
                 memset(output, 0, sizeof(output));
             }
             fbVal[0] = fbVal[1] = 0.f;
-            return;
+            outputRendered = false;
+            return false;
         }
 
+        if (tablePending || windowTablePending)
+            pickUpPendingTables();
+
         /*
          * Apply modulation
          */
@@ -374,7 +469,7 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
         lfoProcess();
         auto lfoFac = *lfoFacP;
 
-        auto rf = monoValues.twoToTheX.twoToThe(
+        rf = monoValues.twoToTheX.twoToThe(
                       ratio +
                       envRatioAtten * (envToRatio + centsScale * envToRatioFine) *
                           env.outputCache[blockSize - 1] +
@@ -386,37 +481,213 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
         if (firstTime)
             priorRF = rf;
         firstTime = false;
-        auto dRF = (rf - priorRF) / blockSize;
+        dRF = (rf - priorRF) / blockSize;
         std::swap(rf, priorRF);
 
-        if (softResetPhaseCount > 0)
+        outputContinues = outputRendered;
+        outputRendered = true;
+        return true;
+    }
+
+    // The voice-packed path only takes the plain table lookup; extended modes and
+    // the soft reset crossfade stay on the per-voice innerLoop.
+    bool canRenderPacked() const
+    {
+        return extendedModeCachedAtAttack == Patch::SourceNode::ExtendedMode::NONE &&
+               softResetPhaseCount <= 0;
+    }
+
+    /*
+     * The phase pass of the two-pass no-feedback loop. Fills ph with the lookup phase
+     * (accumulated phase plus phaseInput) for every sample of the block and advances
+     * rf, phs and dPhase exactly as the per-sample loop would. The frequency to
+     * phase-increment math is vectorised in SinTable::dPhaseBlock; the running sum
+     * of increments is an in-register prefix sum per quad, carrying the last lane
+     * forward, so nothing in here waits on a table load.
+     */
+    void blockPhases(float &rf, const float dRF, uint32_t &phs, uint32_t *ph)
+    {
+        static_assert(blockSize % 4 == 0);
+        float rfs alignas(16)[blockSize];
+        for (int i = 0; i < blockSize; ++i)
         {
-            float newOutput alignas(16)[blockSize];
-            innerLoop(output, fbVal, rf, dRF, phase);
-            innerLoop(newOutput, softFb, rf, dRF, softPhase);
-            float p0 = 1.f * softResetPhaseCount / softPhaseCount;
+            rfs[i] = rf;
+            rf += dRF;
+        }
 
-            for (int i = 0; i < blockSize; ++i)
+        int32_t dph alignas(16)[blockSize];
+        st.dPhaseBlock<blockSize>(baseFrequency, fmAmount, rfs, dph);
+
+        auto run = SIMD_MM(set1_epi32)((int32_t)phs);
+        for (int i = 0; i < blockSize; i += 4)
+        {
+            auto d = SIMD_MM(load_si128)((const SIMD_M128I *)(dph + i));
+            d = SIMD_MM(add_epi32)(d, SIMD_MM(slli_si128)(d, 4));
+            d = SIMD_MM(add_epi32)(d, SIMD_MM(slli_si128)(d, 8));
+            auto p = SIMD_MM(add_epi32)(run, d);
+            auto pin = SIMD_MM(load_si128)((const SIMD_M128I *)(phaseInput + i));
+            SIMD_MM(store_si128)((SIMD_M128I *)(ph + i), SIMD_MM(add_epi32)(p, pin));
+            run = SIMD_MM(shuffle_epi32)(p, 0xFF);
+        }
+        phs = (uint32_t)SIMD_MM(cvtsi128_si32)(run);
+        dPhase = dph[blockSize - 1];
+    }
+
+    /*
+     * The lookup pass of the two-pass no-feedback loop for EM::NONE, scaled by
+     * rmLevel, which is where the adaptive rate estimate and choice are made.
+     */
+    void lookupBlock(const uint32_t *ph, float *onto)
+    {
+        if (adaptiveRate && waveFormCachedAtAttack == SinTable::SIN)
+        {
+            int64_t maxStep{0};
+            for (int i = 1; i < blockSize; ++i)
+                maxStep = std::max(maxStep, std::abs((int64_t)(int32_t)(ph[i] - ph[i - 1])));
+            bandwidth = maxStep * (1.f / phase::phaseMaxF) + modBandwidth;
+
+            if (bandwidth < reducedRateBandwidth && outputContinues && onto == output)
             {
-                auto fac = p0 - i * dSoftPhase;
-                output[i] = fac * output[i] + (1 - fac) * newOutput[i];
+                lookupReduced(ph);
+                return;
             }
-            softResetPhaseCount--;
+        }
+        st.atBlock<blockSize>(ph, rmLevel, onto);
+    }
 
-            if (softResetPhaseCount == 0)
+    /*
+     * Looks up the odd samples of the block and fills each even one with the four
+     * point Lagrange midpoint of the odd samples around it, reaching back into the
+     * previous block's output for the first. The last even sample has only one odd
+     * sample after it, so it takes the three before and that one.
+     *
+     * For a sine at f cycles per sample the midpoint is off by about
+     * 3 / 8 (2 pi f)^4 of the amplitude, -66 dB at reducedRateBandwidth (-62 dB for
+     * the end sample). Since only the even samples carry it, half of that error sits
+     * at f and half images to 0.5 - f cycles per sample, which is far above the host
+     * band the resampler keeps.
+     */
+    void lookupReduced(const uint32_t *ph)
+    {
+        static constexpr int half{blockSize / 2};
+        uint32_t oddPh alignas(16)[half];
+        float oddScale alignas(16)[half];
+        for (int k = 0; k < half; ++k)
+        {
+            oddPh[k] = ph[2 * k + 1];
+            oddScale[k] = rmLevel[2 * k + 1];
+        }
+
+        // The odd samples of this block, after the last two of the previous one
+        float odd alignas(16)[half + 2];
+        odd[0] = output[blockSize - 3];
+        odd[1] = output[blockSize - 1];
+        st.atBlock<half>(oddPh, oddScale, odd + 2);
+
+        for (int k = 0; k < half - 1; ++k)
+            output[2 * k] = (9.f * (odd[k + 1] + odd[k + 2]) - (odd[k] + odd[k + 3])) * 0.0625f;
+        output[blockSize - 2] =
+            (odd[half - 2] - 5.f * odd[half - 1] + 15.f * odd[half] + 5.f * odd[half + 1]) *
+            0.0625f;
+        for (int k = 0; k < half; ++k)
+            output[2 * k + 1] = odd[k + 2];
+    }
+
+    /*
+     * Render the EM::NONE inner loop for up to SinTable::lanes operators at once,
+     * typically the same op index across several voices. The phase and feedback
+     * math stays per lane (it is serial within a voice) but the table lookup
+     * happens for all lanes in one SinTable::atLanes call. Each op must already
+     * have run beginBlock, with rf / dRF holding what it returned.
+     *
+     * Ops without self feedback this block don't need the lane loop at all; they
+     * take the two-pass path (blockPhases then a scaled SinTable::atBlock) one op
+     * at a time, and only the feedback ops are packed.
+     */
+    static void renderPacked(OpSource *const ops[SinTable::lanes], int n,
+                             float rf[SinTable::lanes], const float dRF[SinTable::lanes])
+    {
+        assert(n > 0 && n <= SinTable::lanes);
+
+        if constexpr (batchedTableLookup)
+        {
+            OpSource *fbOps[SinTable::lanes];
+            float fbRF[SinTable::lanes], fbDRF[SinTable::lanes];
+            int nfb{0};
+            for (int l = 0; l < n; ++l)
             {
-                phase = softPhase;
-                fbVal[0] = softFb[0];
-                fbVal[1] = softFb[1];
+                auto &o = *ops[l];
+                if (o.hasActiveFeedback)
+                {
+                    fbOps[nfb] = &o;
+                    fbRF[nfb] = rf[l];
+                    fbDRF[nfb] = dRF[l];
+                    nfb++;
+                    continue;
+                }
+                uint32_t ph alignas(16)[blockSize];
+                o.blockPhases(rf[l], dRF[l], o.phase, ph);
+                o.lookupBlock(ph, o.output);
+            }
+            if (nfb == 0)
+                return;
+            if (nfb < n)
+            {
+                renderPackedLanes(fbOps, nfb, fbRF, fbDRF);
+                return;
             }
         }
-        else
+        renderPackedLanes(ops, n, rf, dRF);
+    }
+
+    static void renderPackedLanes(OpSource *const ops[SinTable::lanes], int n,
+                                  float rf[SinTable::lanes], const float dRF[SinTable::lanes])
+    {
+        const SIMD_M128 *quads[SinTable::lanes];
+        uint32_t ph alignas(16)[SinTable::lanes]{};
+        float out alignas(16)[SinTable::lanes];
+        for (int l = 0; l < SinTable::lanes; ++l)
+            quads[l] = ops[l < n ? l : 0]->st.simdQuad;
+
+        for (int i = 0; i < blockSize; ++i)
         {
-            innerLoop(output, fbVal, rf, dRF, phase);
+            for (int l = 0; l < n; ++l)
+            {
+                auto &o = *ops[l];
+                o.dPhase = o.st.dPhase((o.baseFrequency * (1.0 + o.fmAmount[i])) * rf[l]);
+                rf[l] += dRF[l];
+                o.phase += o.dPhase;
+
+                if (o.hasActiveFeedback)
+                {
+                    auto fb = 0.5 * (o.fbVal[0] + o.fbVal[1]);
+                    auto sb = (o.feedbackLevel[i] < 0);
+                    fb = fb * (1 - sb * (1 - fb));
+                    ph[l] = o.phase + o.phaseInput[i] + (int32_t)(o.feedbackLevel[i] * fb);
+                }
+                else
+                {
+                    ph[l] = o.phase + o.phaseInput[i];
+                }
+            }
+
+            SIMD_MM(store_ps)(out, SinTable::atLanes(quads, ph));
+
+            for (int l = 0; l < n; ++l)
+            {
+                auto &o = *ops[l];
+                auto v = out[l] * o.rmLevel[i];
+                o.output[i] = v;
+                if (o.hasActiveFeedback)
+                {
+                    o.fbVal[1] = o.fbVal[0];
+                    o.fbVal[0] = v;
+                }
+            }
         }
     }
 
-    static constexpr int softPhaseCount{16};
+    static constexpr int softPhaseCount{128 / blockSize}; // blocks, so 128 samples
     static constexpr float dSoftPhase{1.f / (blockSize * softPhaseCount)};
     int softResetPhaseCount{-1};
     uint32_t softPhase{0};
@@ -552,6 +823,26 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
         }
     }
 
+    template <Patch::SourceNode::PhaseMapShape S>
+    static uint32_t remapPhase(uint32_t ph, float m)
+    {
+        using PM = Patch::SourceNode::PhaseMapShape;
+        if constexpr (S == PM::SAW)
+            return remap::remapSaw(ph & phase::phaseMask, m);
+        else if constexpr (S == PM::SQUARE)
+            return remap::remapSquare(ph & phase::phaseMask, m);
+        else if constexpr (S == PM::PULSE)
+            return remap::remapPulse(ph & phase::phaseMask, m);
+        else if constexpr (S == PM::DOUBLE)
+            return remap::remapDoubleSine(ph & phase::phaseMask, m);
+        else if constexpr (S == PM::SIN_TO_SQUARE)
+            return remap::remapSinToSquare(ph & phase::phaseMask, m);
+        else if constexpr (S == PM::DOUBLE_SAW)
+            return remap::remapDoubleSaw(ph & phase::phaseMask, m);
+        else
+            return ph;
+    }
+
     template <
         bool UsesFB, Patch::SourceNode::ExtendedMode ET,
         Patch::SourceNode::PhaseMapShape S = Patch::SourceNode::PhaseMapShape::SAW,
@@ -597,6 +888,27 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
             lfsrMode = lfsrModeCachedAtAttack;
         }
 
+        if constexpr (!UsesFB && batchedTableLookup && (ET == EM::NONE || ET == EM::PHASE_REMAP))
+        {
+            // Without feedback every phase in the block is known before the first
+            // lookup, so compute them all in one pass and look them up as a batch.
+            uint32_t ph alignas(16)[blockSize];
+            blockPhases(rf, dRF, phs, ph);
+            if constexpr (ET == EM::PHASE_REMAP)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    ph[i] = remapPhase<S>(ph[i], nextM);
+                    nextM += dM;
+                }
+            }
+            if constexpr (ET == EM::NONE)
+                lookupBlock(ph, onto);
+            else
+                st.atBlock<blockSize>(ph, rmLevel, onto);
+            return;
+        }
+
         for (int i = 0; i < blockSize; ++i)
         {
             dPhase = st.dPhase((baseFrequency * (1.0 + fmAmount[i])) * rf);
@@ -630,19 +942,7 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
             float out;
             if constexpr (ET == EM::PHASE_REMAP)
             {
-                using PM = Patch::SourceNode::PhaseMapShape;
-                if constexpr (S == PM::SAW)
-                    ph = remap::remapSaw(ph & phase::phaseMask, nextM);
-                else if constexpr (S == PM::SQUARE)
-                    ph = remap::remapSquare(ph & phase::phaseMask, nextM);
-                else if constexpr (S == PM::PULSE)
-                    ph = remap::remapPulse(ph & phase::phaseMask, nextM);
-                else if constexpr (S == PM::DOUBLE)
-                    ph = remap::remapDoubleSine(ph & phase::phaseMask, nextM);
-                else if constexpr (S == PM::SIN_TO_SQUARE)
-                    ph = remap::remapSinToSquare(ph & phase::phaseMask, nextM);
-                else if constexpr (S == PM::DOUBLE_SAW)
-                    ph = remap::remapDoubleSaw(ph & phase::phaseMask, nextM);
+                ph = remapPhase<S>(ph, nextM);
                 nextM += dM;
                 out = st.at(ph);
             }
@@ -789,6 +1089,18 @@ struct alignas(16) OpSource : public EnvelopeSupport<Patch::SourceNode>,
     // Used by RESONANT_SWEEP for table-based windows (Hann / Blackman-Harris / Tukey).
     // Independent of `st` so the operator's main waveform stays selectable freely.
     SinTable stWindow;
+    SinTable::WaveForm windowWaveForm{SinTable::HANN_WINDOW};
+
+    // Set when attack found a table unbuilt and st / stWindow are reading the SIN /
+    // HANN fallback until the main thread has built it (see SinTable::setWaveForm)
+    bool tablePending{false}, windowTablePending{false};
+    void pickUpPendingTables()
+    {
+        if (tablePending && SinTable::isBuilt(waveFormCachedAtAttack))
+            tablePending = !st.setWaveForm(waveFormCachedAtAttack);
+        if (windowTablePending && SinTable::isBuilt(windowWaveForm))
+            windowTablePending = !stWindow.setWaveForm(windowWaveForm, SinTable::HANN_WINDOW);
+    }
     float fbVal[2]{0.f, 0.f};
 
     // 16-sample noise buffer drained across two blocks (blockSize = 8). NoiseHelper
@@ -0,0 +1,173 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#ifndef BACONPAUL_SIX_SINES_DSP_POLYPHASE_DECIMATOR_H
+#define BACONPAUL_SIX_SINES_DSP_POLYPHASE_DECIMATOR_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+
+#include "configuration.h"
+#include <sst/basic-blocks/simd/setup.h>
+
+namespace baconpaul::six_sines
+{
+/*
+ * Lanczos (A=4) resampling from the engine rate down to the host rate for every
+ * output bus at once.
+ *
+ * The engine runs at a fixed multiple of 44.1 or 48k (SampleRateStrategy), so
+ * engine / host is a ratio p / q with a small q, 1 or 2 at the usual host
+ * rates. The fractional read position then only takes q values, and the eight
+ * kernel taps for each are computed once in setRates. Channels are stored
+ * interleaved four to a SIMD register, so one multiply-add per tap filters four
+ * channels, and pushing a block is one transposing copy.
+ *
+ * setRates returns false for a ratio it can't express with at most maxPhases
+ * phases; the caller keeps the general resampler for those.
+ */
+template <size_t maxChannels> struct PolyphaseDecimator
+{
+    static constexpr int A{4}, taps{2 * A};
+    static constexpr size_t maxGroups{(maxChannels + 3) / 4};
+    static constexpr int maxPhases{16}, maxRatio{8};
+
+    // Between produce calls the ring holds at most the frames for one host block
+    // of output, one engine block of overshoot and the taps either side
+    static constexpr int64_t ringFor(int64_t frames)
+    {
+        int64_t r{1};
+        while (r < frames)
+            r <<= 1;
+        return r;
+    }
+    static constexpr int64_t ringSize{ringFor(blockSize * (maxRatio + 1) + 2 * taps)};
+    static constexpr int64_t ringMask{ringSize - 1};
+
+    SIMD_M128 ring alignas(16)[ringSize][maxGroups];
+    float coef[maxPhases][taps];
+
+    size_t channels{2}, groups{1};
+    int64_t p{1}, q{1};
+    int64_t written{0}; // frames ever pushed
+    int64_t readWhole{0};
+    int64_t readPhase{0}; // read position is readWhole + readPhase / q
+
+    bool setRates(int64_t engineRate, int64_t hostRate, size_t nChannels)
+    {
+        if (engineRate <= 0 || hostRate <= 0 || nChannels > maxChannels)
+            return false;
+        auto g = std::gcd(engineRate, hostRate);
+        p = engineRate / g;
+        q = hostRate / g;
+        if (q > maxPhases || p < q || p > maxRatio * q)
+            return false;
+
+        channels = nChannels;
+        groups = (channels + 3) / 4;
+
+        for (int ph = 0; ph < q; ++ph)
+        {
+            double frac = 1.0 * ph / q, sum{0};
+            for (int k = 0; k < taps; ++k)
+            {
+                coef[ph][k] = (float)lanczos(frac + A - 1 - k);
+                sum += coef[ph][k];
+            }
+            // So DC comes through at exactly unity whatever the phase
+            for (int k = 0; k < taps; ++k)
+                coef[ph][k] = (float)(coef[ph][k] / sum);
+        }
+
+        reset();
+        return true;
+    }
+
+    void reset()
+    {
+        memset(ring, 0, sizeof(ring));
+        // A frames of silence ahead of the first push, so the first output's
+        // taps reaching back before it read zeros
+        written = A;
+        readWhole = A - 1;
+        readPhase = 0;
+    }
+
+    // One engine block of every channel, laid out as in[channel][sample]
+    void push(const float in[][blockSize])
+    {
+        for (int i = 0; i < blockSize; ++i)
+        {
+            auto *frame = ring[(written + i) & ringMask];
+            float lanes alignas(16)[maxGroups * 4]{};
+            for (size_t c = 0; c < channels; ++c)
+                lanes[c] = in[c][i];
+            for (size_t g = 0; g < groups; ++g)
+                frame[g] = SIMD_MM(load_ps)(lanes + 4 * g);
+        }
+        written += blockSize;
+    }
+
+    bool canProduce(int n) const
+    {
+        auto lastWhole = readWhole + (readPhase + p * (n - 1)) / q;
+        return lastWhole + A < written;
+    }
+
+    // n output frames of every channel, to out[channel] + offset
+    void produce(float *const *out, int n, int offset = 0)
+    {
+        for (int o = 0; o < n; ++o)
+        {
+            const auto *c = coef[readPhase];
+            auto first = readWhole - A + 1;
+            SIMD_M128 acc[maxGroups];
+            for (size_t g = 0; g < groups; ++g)
+                acc[g] = SIMD_MM(setzero_ps)();
+            for (int k = 0; k < taps; ++k)
+            {
+                const auto *frame = ring[(first + k) & ringMask];
+                auto ck = SIMD_MM(set1_ps)(c[k]);
+                for (size_t g = 0; g < groups; ++g)
+                    acc[g] = SIMD_MM(add_ps)(acc[g], SIMD_MM(mul_ps)(frame[g], ck));
+            }
+
+            float res alignas(16)[maxGroups * 4];
+            for (size_t g = 0; g < groups; ++g)
+                SIMD_MM(store_ps)(res + 4 * g, acc[g]);
+            for (size_t ch = 0; ch < channels; ++ch)
+                out[ch][offset + o] = res[ch];
+
+            readPhase += p;
+            readWhole += readPhase / q;
+            readPhase %= q;
+        }
+    }
+
+  private:
+    static double lanczos(double x)
+    {
+        if (std::fabs(x) < 1e-9)
+            return 1.0;
+        if (std::fabs(x) >= A)
+            return 0.0;
+        auto px = M_PI * x;
+        return A * std::sin(px) * std::sin(px / A) / (px * px);
+    }
+};
+} // namespace baconpaul::six_sines
+#endif // BACONPAUL_SIX_SINES_DSP_POLYPHASE_DECIMATOR_H
@@ -16,9 +16,11 @@
 #ifndef BACONPAUL_SIX_SINES_DSP_SINTABLE_H
 #define BACONPAUL_SIX_SINES_DSP_SINTABLE_H
 
+#include <atomic>
 #include <cassert>
 #include <cstring>
 #include <functional>
+#include <mutex>
 #include <utility>
 
 #include "configuration.h"
@@ -84,17 +86,38 @@ struct SinTable
     };
 
     static constexpr size_t nPoints{1 << 12}, nQuadrants{4};
-    static double xTable[nQuadrants][nPoints + 1];
-    static float quadrantTable[NUM_WAVEFORMS][nQuadrants][nPoints + 1];
-    static float dQuadrantTable[NUM_WAVEFORMS][nQuadrants][nPoints + 1];
-
-    static float cubicHermiteCoefficients[nQuadrants][nPoints];
-    static float linterpCoefficients[2][nPoints];
 
+    /*
+     * Each waveform's table is built the first time it is asked for rather than all
+     * at startup, so a table nobody uses is never written and its pages never become
+     * resident. initializeStatics builds the ones every voice needs (SIN, and HANN
+     * for the resonant sweep window). Everything else is built on the main thread
+     * with prepareWaveForm when a patch is loaded or edited. setWaveForm never builds
+     * or waits, since it runs on the audio thread: asked for a table that isn't built
+     * yet (e.g. host automation of the waveform) it reads a fallback table instead and
+     * posts a build request, which the engine hands to the main thread with
+     * request_callback and serviceBuildRequests. The caller switches over once
+     * isBuilt says the table is there.
+     *
+     * initializeStatics is called from clap_init, and again from every SinTable
+     * ctor for hosts of the engine that skip the entry point (the tests, the
+     * render tool). It runs once per process however many threads race to it.
+     */
     static SIMD_M128 simdFullQuad alignas(
         16)[NUM_WAVEFORMS][nQuadrants * nPoints];    // for each quad it is q, q+1, dq + 1
     static SIMD_M128 simdCubic alignas(16)[nPoints]; // it is cq, cq+1, cdq, cd1+1
-    static bool staticsInitialized;
+    static std::once_flag staticsOnce;
+
+    enum BuildState : int
+    {
+        UNBUILT,
+        BUILDING,
+        BUILT
+    };
+    static std::atomic<int> buildState[NUM_WAVEFORMS];
+    static_assert(NUM_WAVEFORMS <= 32, "buildRequests is one bit per waveform");
+    static std::atomic<uint32_t> buildRequests;
+    static std::atomic<bool> buildRequestsPosted;
 
     SIMD_M128 *simdQuad;
 
@@ -108,12 +131,55 @@ struct SinTable
     static void fillTable(int WF, std::function<std::pair<double, double>(double x, int Q)> der);
     static void initializeStatics();
 
-    void setWaveForm(WaveForm wf)
+    // Thread safe; returns once the table for wf is usable
+    static void prepareWaveForm(WaveForm wf)
+    {
+        auto stwf = size_t(wf);
+        if (stwf < NUM_WAVEFORMS && buildState[stwf].load(std::memory_order_acquire) != BUILT)
+            buildWaveForm((int)stwf);
+    }
+    static void buildWaveForm(int WF);
+    static size_t residentTableBytes();
+
+    static bool isBuilt(WaveForm wf)
+    {
+        return size_t(wf) < NUM_WAVEFORMS &&
+               buildState[size_t(wf)].load(std::memory_order_acquire) == BUILT;
+    }
+
+    // Any thread; never builds. Marks wf wanted for the next serviceBuildRequests
+    static void requestBuild(WaveForm wf)
+    {
+        auto bit = 1u << uint32_t(wf);
+        if (!(buildRequests.fetch_or(bit, std::memory_order_relaxed) & bit))
+            buildRequestsPosted.store(true, std::memory_order_release);
+    }
+    // Audio thread; true once per batch of new requests, so the engine knows to ask
+    // the host for a main thread callback
+    static bool takeBuildRequestsPosted()
+    {
+        return buildRequestsPosted.load(std::memory_order_relaxed) &&
+               buildRequestsPosted.exchange(false, std::memory_order_acquire);
+    }
+    // Main thread; builds every requested table
+    static void serviceBuildRequests();
+
+    // Audio thread safe. Reads wf if it is built, otherwise reads fallback (which must
+    // be built, as SIN and HANN_WINDOW always are) and requests wf. Returns whether
+    // wf is what it got.
+    bool setWaveForm(WaveForm wf, WaveForm fallback = SIN)
     {
         auto stwf = size_t(wf);
         if (stwf >= NUM_WAVEFORMS) // mostly remove ine during dev
             stwf = 0;
+        if (buildState[stwf].load(std::memory_order_acquire) != BUILT)
+        {
+            requestBuild((WaveForm)stwf);
+            simdQuad = simdFullQuad[fallback];
+            return false;
+        }
         simdQuad = simdFullQuad[stwf];
+        return true;
     }
 
     double frToPhase{0};
@@ -123,6 +189,35 @@ struct SinTable
         return dph;
     }
 
+    // dPhase(base * (1.0 + fm[i]) * rf[i]) for a block, two lanes at a time in double
+    // precision. Every step (the double products, the round to float for dPhase's
+    // argument and the truncation) is the one the scalar expression takes, so the
+    // results are identical to it. N must be a multiple of 4.
+    template <int N>
+    inline void dPhaseBlock(float base, const float *fm, const float *rf, int32_t *out) const
+    {
+        static_assert(N % 4 == 0);
+        const auto one = SIMD_MM(set1_pd)(1.0);
+        const auto bf = SIMD_MM(set1_pd)((double)base);
+        const auto ftp = SIMD_MM(set1_pd)(frToPhase);
+        auto half = [&](SIMD_M128 f, SIMD_M128 r)
+        {
+            auto fr = SIMD_MM(mul_pd)(
+                SIMD_MM(mul_pd)(bf, SIMD_MM(add_pd)(one, SIMD_MM(cvtps_pd)(f))),
+                SIMD_MM(cvtps_pd)(r));
+            fr = SIMD_MM(cvtps_pd)(SIMD_MM(cvtpd_ps)(fr));
+            return SIMD_MM(cvttpd_epi32)(SIMD_MM(mul_pd)(fr, ftp));
+        };
+        for (int i = 0; i < N; i += 4)
+        {
+            auto f = SIMD_MM(loadu_ps)(fm + i);
+            auto r = SIMD_MM(loadu_ps)(rf + i);
+            auto lo = half(f, r);
+            auto hi = half(SIMD_MM(movehl_ps)(f, f), SIMD_MM(movehl_ps)(r, r));
+            SIMD_MM(storeu_si128)((SIMD_M128I *)(out + i), SIMD_MM(unpacklo_epi64)(lo, hi));
+        }
+    }
+
     // phase is 26 bits, 12 of fractional, 12 of position in the table and 2 of quadrant
     inline float at(const uint32_t ph) const
     {
@@ -140,6 +235,77 @@ struct SinTable
         auto v = SIMD_MM(hadd_ps)(h, h);
         return SIMD_MM(cvtss_f32)(v);
     }
+
+    // at() reduces each q*c product horizontally with two hadds, which are slow on
+    // most x86 cores. The kernels below instead transpose four products and sum
+    // vertically. The sum is ordered (t0+t1)+(t2+t3) to match the double hadd in
+    // at() exactly, so both are bit-identical to it, not merely close.
+    static inline SIMD_M128 sumTransposed(SIMD_M128 r0, SIMD_M128 r1, SIMD_M128 r2, SIMD_M128 r3)
+    {
+        // 4x4 transpose so t[k] holds product term k for each lane
+        auto a0 = SIMD_MM(unpacklo_ps)(r0, r1);
+        auto a1 = SIMD_MM(unpacklo_ps)(r2, r3);
+        auto a2 = SIMD_MM(unpackhi_ps)(r0, r1);
+        auto a3 = SIMD_MM(unpackhi_ps)(r2, r3);
+        auto t0 = SIMD_MM(movelh_ps)(a0, a1);
+        auto t1 = SIMD_MM(movehl_ps)(a1, a0);
+        auto t2 = SIMD_MM(movelh_ps)(a2, a3);
+        auto t3 = SIMD_MM(movehl_ps)(a3, a2);
+
+        return SIMD_MM(add_ps)(SIMD_MM(add_ps)(t0, t1), SIMD_MM(add_ps)(t2, t3));
+    }
+
+    // Four independent lookups, one per lane, each against its own table. This is
+    // the voice-packed form of at().
+    static constexpr int lanes{4};
+    static inline SIMD_M128 atLanes(const SIMD_M128 *const quads[lanes],
+                                    const uint32_t ph[lanes])
+    {
+        static constexpr uint32_t mask{(1 << 12) - 1};
+        static constexpr uint32_t umask{(1 << 14) - 1};
+
+        auto r0 = SIMD_MM(mul_ps)(quads[0][(ph[0] >> 12) & umask], simdCubic[ph[0] & mask]);
+        auto r1 = SIMD_MM(mul_ps)(quads[1][(ph[1] >> 12) & umask], simdCubic[ph[1] & mask]);
+        auto r2 = SIMD_MM(mul_ps)(quads[2][(ph[2] >> 12) & umask], simdCubic[ph[2] & mask]);
+        auto r3 = SIMD_MM(mul_ps)(quads[3][(ph[3] >> 12) & umask], simdCubic[ph[3] & mask]);
+
+        return sumTransposed(r0, r1, r2, r3);
+    }
+
+    // A block of lookups against this table, for loops whose phases are all known
+    // before the first lookup (no self feedback). N must be a multiple of lanes;
+    // out needn't be aligned. The second form scales each result on the way out.
+    template <int N> inline void atBlock(const uint32_t *ph, float *out) const
+    {
+        atBlockImpl<N, false>(ph, nullptr, out);
+    }
+    template <int N> inline void atBlock(const uint32_t *ph, const float *scale, float *out) const
+    {
+        atBlockImpl<N, true>(ph, scale, out);
+    }
+
+    template <int N, bool scaled>
+    inline void atBlockImpl(const uint32_t *ph, const float *scale, float *out) const
+    {
+        static_assert(N % lanes == 0);
+        static constexpr uint32_t mask{(1 << 12) - 1};
+        static constexpr uint32_t umask{(1 << 14) - 1};
+
+        for (int i = 0; i < N; i += lanes)
+        {
+            auto r0 = SIMD_MM(mul_ps)(simdQuad[(ph[i] >> 12) & umask], simdCubic[ph[i] & mask]);
+            auto r1 = SIMD_MM(mul_ps)(simdQuad[(ph[i + 1] >> 12) & umask],
+                                      simdCubic[ph[i + 1] & mask]);
+            auto r2 = SIMD_MM(mul_ps)(simdQuad[(ph[i + 2] >> 12) & umask],
+                                      simdCubic[ph[i + 2] & mask]);
+            auto r3 = SIMD_MM(mul_ps)(simdQuad[(ph[i + 3] >> 12) & umask],
+                                      simdCubic[ph[i + 3] & mask]);
+            auto v = sumTransposed(r0, r1, r2, r3);
+            if constexpr (scaled)
+                v = SIMD_MM(mul_ps)(v, SIMD_MM(loadu_ps)(scale + i));
+            SIMD_MM(storeu_ps)(out + i, v);
+        }
+    }
 };
 } // namespace baconpaul::six_sines
 #endif // SINTABLE_H
@@ -0,0 +1,439 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#include "preset-index.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+#include "configuration.h"
+#include "synth/patch.h"
+#include "presets/preset-manager.h"
+#include "sst/plugininfra/strnatcmp.h"
+
+#include <cmrc/cmrc.hpp>
+
+CMRC_DECLARE(sixsines_patches);
+
+namespace baconpaul::six_sines::presets
+{
+namespace
+{
+static constexpr char cacheMagic[4]{'S', 'X', 'S', 'I'};
+static constexpr uint32_t cacheVersion{1};
+
+template <typename T> void appendPod(std::string &s, T v)
+{
+    s.append((const char *)&v, sizeof(v));
+}
+void appendString(std::string &s, const std::string &v)
+{
+    appendPod(s, (uint32_t)v.size());
+    s.append(v);
+}
+
+struct CacheReader
+{
+    const std::string &data;
+    size_t pos{0};
+
+    template <typename T> bool readPod(T &v)
+    {
+        if (sizeof(T) > data.size() - pos)
+            return false;
+        memcpy(&v, data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+    bool readString(std::string &v)
+    {
+        uint32_t len;
+        if (!readPod(len) || len > data.size() - pos)
+            return false;
+        v = data.substr(pos, len);
+        pos += len;
+        return true;
+    }
+};
+
+bool readWholeFile(const fs::path &p, std::string &into)
+{
+    std::ifstream t(p, std::ios::binary);
+    if (!t.is_open())
+        return false;
+    std::stringstream buffer;
+    buffer << t.rdbuf();
+    into = buffer.str();
+    return true;
+}
+
+bool statFile(const fs::path &p, int64_t &mtime, uint64_t &size)
+{
+    std::error_code ec;
+    auto t = fs::last_write_time(p, ec);
+    if (ec)
+        return false;
+    auto sz = fs::file_size(p, ec);
+    if (ec)
+        return false;
+    mtime = (int64_t)t.time_since_epoch().count();
+    size = (uint64_t)sz;
+    return true;
+}
+} // namespace
+
+PresetIndex::PresetIndex(const fs::path &up, const fs::path &cp)
+    : userPatchesPath(up), cachePath(cp)
+{
+    auto s = std::make_shared<Snapshot>();
+    s->factory = readFactory();
+    s->user = readCache();
+    current = s;
+    gen = 1;
+
+    // The cache may be stale, so check it against the disk straight away
+    rescanPending = true;
+    worker = std::thread([this]() { run(); });
+}
+
+PresetIndex::~PresetIndex()
+{
+    {
+        auto lg = std::lock_guard(workMutex);
+        stopping = true;
+    }
+    workCV.notify_all();
+    if (worker.joinable())
+        worker.join();
+}
+
+std::shared_ptr<PresetIndex> PresetIndex::shared(const fs::path &userPatchesPath,
+                                                 const fs::path &cachePath)
+{
+    static std::mutex sharedMutex;
+    static std::weak_ptr<PresetIndex> sharedIndex;
+
+    auto lg = std::lock_guard(sharedMutex);
+    auto res = sharedIndex.lock();
+    if (!res)
+    {
+        res = std::make_shared<PresetIndex>(userPatchesPath, cachePath);
+        sharedIndex = res;
+    }
+    return res;
+}
+
+std::shared_ptr<const PresetIndex::Snapshot> PresetIndex::snapshot() const
+{
+    auto lg = std::lock_guard(snapshotMutex);
+    return current;
+}
+
+void PresetIndex::requestRescan()
+{
+    {
+        auto lg = std::lock_guard(workMutex);
+        rescanPending = true;
+    }
+    workCV.notify_all();
+}
+
+void PresetIndex::waitForRescan()
+{
+    auto lk = std::unique_lock(workMutex);
+    workCV.wait(lk, [this]() { return (!rescanPending && !scanning) || stopping; });
+}
+
+void PresetIndex::run()
+{
+    auto lk = std::unique_lock(workMutex);
+    while (true)
+    {
+        workCV.wait(lk, [this]() { return rescanPending || stopping; });
+        if (stopping)
+            break;
+        rescanPending = false;
+        scanning = true;
+        lk.unlock();
+
+        auto prior = snapshot()->user;
+        auto user = scan(prior);
+        if (user.has_value())
+        {
+            auto same = [](const Entry &a, const Entry &b)
+            { return a.path == b.path && a.mtime == b.mtime && a.size == b.size; };
+            if (!std::equal(prior.begin(), prior.end(), user->begin(), user->end(), same))
+            {
+                writeCache(*user);
+                publish(std::move(*user));
+            }
+        }
+
+        lk.lock();
+        scanning = false;
+        workCV.notify_all();
+    }
+}
+
+std::optional<std::vector<PresetIndex::Entry>>
+PresetIndex::scan(const std::vector<Entry> &prior)
+{
+    std::unordered_map<std::string, const Entry *> byPath;
+    for (const auto &e : prior)
+        byPath[e.path.u8string()] = &e;
+
+    std::vector<Entry> res;
+    try
+    {
+        std::error_code ec;
+        if (!fs::is_directory(userPatchesPath, ec))
+            return res;
+
+        for (auto it = fs::recursive_directory_iterator(userPatchesPath, ec);
+             !ec && it != fs::recursive_directory_iterator(); it.increment(ec))
+        {
+            if (stopping)
+                return std::nullopt;
+
+            auto elp = it->path();
+            if (!fs::is_regular_file(elp, ec) || elp.extension() != ".sxsnp")
+                continue;
+
+            Entry e;
+            e.path = elp.lexically_relative(userPatchesPath);
+            if (!statFile(elp, e.mtime, e.size))
+                continue;
+
+            auto prev = byPath.find(e.path.u8string());
+            if (prev != byPath.end() && prev->second->mtime == e.mtime &&
+                prev->second->size == e.size)
+            {
+                res.push_back(*prev->second);
+                continue;
+            }
+
+            if (!fillFromFile(e, elp))
+                continue;
+            e.category = e.path.parent_path().u8string();
+            res.push_back(std::move(e));
+        }
+    }
+    catch (fs::filesystem_error &e)
+    {
+        SXSNLOG("Preset index scan failed " << e.what());
+    }
+
+    sortUser(res);
+    return res;
+}
+
+void PresetIndex::publish(std::vector<Entry> user)
+{
+    auto s = std::make_shared<Snapshot>();
+    s->factory = snapshot()->factory;
+    s->user = std::move(user);
+    {
+        auto lg = std::lock_guard(snapshotMutex);
+        current = s;
+    }
+    gen++;
+}
+
+std::optional<PresetIndex::Entry> PresetIndex::userEntryFor(const fs::path &p) const
+{
+    Entry e;
+    if (!statFile(p, e.mtime, e.size))
+        return std::nullopt;
+    e.path = p.lexically_relative(userPatchesPath);
+
+    auto s = snapshot();
+    for (const auto &u : s->user)
+        if (u.path == e.path && u.mtime == e.mtime && u.size == e.size)
+            return u;
+
+    if (!fillFromFile(e, p))
+        return std::nullopt;
+    auto inUserDir = !e.path.empty() && e.path.begin()->u8string() != "..";
+    if (inUserDir)
+        e.category = e.path.parent_path().u8string();
+    return e;
+}
+
+uint64_t PresetIndex::contentHash(const std::string &data)
+{
+    // FNV-1a, 64 bit
+    uint64_t h{0xcbf29ce484222325ULL};
+    for (auto c : data)
+    {
+        h ^= (uint8_t)c;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+void PresetIndex::sortUser(std::vector<Entry> &entries)
+{
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry &ea, const Entry &eb)
+              {
+                  const auto &a = ea.path;
+                  const auto &b = eb.path;
+                  auto appe = a.parent_path().empty();
+                  auto bppe = b.parent_path().empty();
+
+                  if (appe && bppe)
+                  {
+                      return strnatcasecmp(a.filename().u8string().c_str(),
+                                           b.filename().u8string().c_str()) < 0;
+                  }
+                  else if (appe)
+                  {
+                      return true;
+                  }
+                  else if (bppe)
+                  {
+                      return false;
+                  }
+                  else
+                  {
+                      return a < b;
+                  }
+              });
+}
+
+std::vector<PresetIndex::Entry> PresetIndex::readFactory()
+{
+    std::vector<Entry> res;
+    try
+    {
+        auto rfs = cmrc::sixsines_patches::get_filesystem();
+        const auto root = std::string(PresetManager::factoryPath);
+        for (const auto &d : rfs.iterate_directory(root))
+        {
+            if (!d.is_directory())
+                continue;
+            for (const auto &p : rfs.iterate_directory(root + "/" + d.filename()))
+            {
+                auto f = rfs.open(root + "/" + d.filename() + "/" + p.filename());
+                auto data = std::string(f.begin(), f.end());
+
+                Entry e;
+                e.path = fs::path(d.filename()) / p.filename();
+                e.size = data.size();
+                e.hash = contentHash(data);
+                e.category = d.filename();
+                Patch::readStateInfo(data.data(), data.size(), e.name, e.author);
+                res.push_back(std::move(e));
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        SXSNLOG(e.what());
+    }
+
+    std::sort(res.begin(), res.end(),
+              [](const Entry &a, const Entry &b)
+              {
+                  if (a.category != b.category)
+                      return a.category < b.category;
+                  return strnatcasecmp(a.path.filename().u8string().c_str(),
+                                       b.path.filename().u8string().c_str()) < 0;
+              });
+    return res;
+}
+
+bool PresetIndex::fillFromFile(Entry &e, const fs::path &full)
+{
+    std::string data;
+    if (!readWholeFile(full, data))
+        return false;
+    e.size = data.size();
+    e.hash = contentHash(data);
+    if (!Patch::readStateInfo(data.data(), data.size(), e.name, e.author) || e.name.empty())
+        e.name = full.filename().replace_extension("").u8string();
+    return true;
+}
+
+std::vector<PresetIndex::Entry> PresetIndex::readCache() const
+{
+    std::vector<PresetIndex::Entry> res;
+    std::string data;
+    if (!readWholeFile(cachePath, data) || data.size() < sizeof(cacheMagic) ||
+        memcmp(data.data(), cacheMagic, sizeof(cacheMagic)) != 0)
+        return res;
+
+    CacheReader r{data, sizeof(cacheMagic)};
+    uint32_t version, count;
+    std::string root;
+    if (!r.readPod(version) || version != cacheVersion || !r.readString(root) ||
+        root != userPatchesPath.u8string() || !r.readPod(count))
+        return res;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        Entry e;
+        std::string path;
+        if (!r.readString(path) || !r.readPod(e.mtime) || !r.readPod(e.size) ||
+            !r.readPod(e.hash) || !r.readString(e.name) || !r.readString(e.author) ||
+            !r.readString(e.category))
+            return {};
+        e.path = fs::u8path(path);
+        res.push_back(std::move(e));
+    }
+    return res;
+}
+
+void PresetIndex::writeCache(const std::vector<Entry> &entries) const
+{
+    std::string data;
+    data.append(cacheMagic, sizeof(cacheMagic));
+    appendPod(data, cacheVersion);
+    appendString(data, userPatchesPath.u8string());
+    appendPod(data, (uint32_t)entries.size());
+    for (const auto &e : entries)
+    {
+        appendString(data, e.path.u8string());
+        appendPod(data, e.mtime);
+        appendPod(data, e.size);
+        appendPod(data, e.hash);
+        appendString(data, e.name);
+        appendString(data, e.author);
+        appendString(data, e.category);
+    }
+
+    // Write aside and rename, so another process never reads half a cache
+    try
+    {
+        auto tmp = cachePath;
+        tmp += ".tmp";
+        {
+            std::ofstream ofs(tmp, std::ios::binary);
+            if (!ofs.is_open())
+                return;
+            ofs.write(data.data(), data.size());
+            if (!ofs)
+                return;
+        }
+        fs::rename(tmp, cachePath);
+    }
+    catch (fs::filesystem_error &e)
+    {
+        SXSNLOG("Unable to write preset index " << e.what());
+    }
+}
+} // namespace baconpaul::six_sines::presets
@@ -0,0 +1,111 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#ifndef BACONPAUL_SIX_SINES_PRESETS_PRESET_INDEX_H
+#define BACONPAUL_SIX_SINES_PRESETS_PRESET_INDEX_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "filesystem/import.h"
+
+namespace baconpaul::six_sines::presets
+{
+/*
+ * What the preset menus and CLAP preset discovery need to know about each preset,
+ * without opening the files.
+ *
+ * The factory entries come from the embedded filesystem once per process. The user
+ * entries are kept in a cache file next to the user patches and brought up to date
+ * on a worker thread: a file whose mtime and size match its cached entry is not
+ * read again, so a rescan of an unchanged library is one directory walk.
+ *
+ * Every PresetManager in the process shares one index through shared(). Readers
+ * take a snapshot, which is never modified once published; a rescan publishes a
+ * new one and bumps generation().
+ */
+struct PresetIndex
+{
+    struct Entry
+    {
+        // Relative to the user patches directory, or category / file for factory
+        fs::path path;
+        int64_t mtime{0};
+        uint64_t size{0};
+        uint64_t hash{0}; // of the file contents
+        std::string name, author, category;
+    };
+
+    struct Snapshot
+    {
+        std::vector<Entry> factory; // sorted by category then name
+        std::vector<Entry> user;    // top level first, then by directory
+    };
+
+    PresetIndex(const fs::path &userPatchesPath, const fs::path &cachePath);
+    ~PresetIndex();
+
+    // The instance every PresetManager in the process shares; it lives as long as
+    // one of them holds it
+    static std::shared_ptr<PresetIndex> shared(const fs::path &userPatchesPath,
+                                               const fs::path &cachePath);
+
+    std::shared_ptr<const Snapshot> snapshot() const;
+    uint64_t generation() const { return gen; }
+
+    // Rescan the user directory on the worker; requests made while one is running
+    // coalesce into one more pass
+    void requestRescan();
+    void waitForRescan();
+
+    // The entry for a user preset at an absolute path, from the snapshot if it is
+    // current and from the file otherwise
+    std::optional<Entry> userEntryFor(const fs::path &p) const;
+
+    static uint64_t contentHash(const std::string &data);
+    static void sortUser(std::vector<Entry> &);
+
+  protected:
+    fs::path userPatchesPath, cachePath;
+
+    mutable std::mutex snapshotMutex;
+    std::shared_ptr<const Snapshot> current;
+    std::atomic<uint64_t> gen{0};
+
+    std::mutex workMutex;
+    std::condition_variable workCV;
+    bool rescanPending{false}, scanning{false};
+    std::atomic<bool> stopping{false};
+    std::thread worker;
+
+    void run();
+    // Empty if the index was destroyed part way through
+    std::optional<std::vector<Entry>> scan(const std::vector<Entry> &prior);
+    void publish(std::vector<Entry> user);
+
+    static std::vector<Entry> readFactory();
+    static bool fillFromFile(Entry &, const fs::path &full);
+    std::vector<Entry> readCache() const;
+    void writeCache(const std::vector<Entry> &) const;
+};
+} // namespace baconpaul::six_sines::presets
+#endif // BACONPAUL_SIX_SINES_PRESETS_PRESET_INDEX_H
@@ -16,9 +16,10 @@
 #include "preset-manager.h"
 #include <sstream>
 #include <fstream>
+#include <memory>
+#include <algorithm>
 #include "sst/plugininfra/paths.h"
 
-#include "sst/plugininfra/strnatcmp.h"
 
 #include <cmrc/cmrc.hpp>
 
@@ -43,103 +44,47 @@ PresetManager::PresetManager(const clap_host_t *ch) : clapHost(ch)
         SXSNLOG("Unable to create user dir " << e.what());
     }
 
-    try
-    {
-        auto fs = cmrc::sixsines_patches::get_filesystem();
-        for (const auto &d : fs.iterate_directory(factoryPath))
-        {
-            if (d.is_directory())
-            {
-                std::vector<std::string> ents;
-                for (const auto &p :
-                     fs.iterate_directory(std::string() + factoryPath + "/" + d.filename()))
-                {
-                    ents.push_back(p.filename());
-                }
-
-                std::sort(ents.begin(), ents.end(), [](const auto &a, const auto &b)
-                          { return strnatcasecmp(a.c_str(), b.c_str()) < 0; });
-                factoryPatchNames[d.filename()] = ents;
-            }
-        }
+    index = PresetIndex::shared(userPatchesPath, userPath / "PresetIndex.sxsni");
 
-        factoryPatchVector.clear();
-        for (const auto &[c, st] : factoryPatchNames)
-        {
-            for (const auto &pn : st)
-            {
-                factoryPatchVector.emplace_back(c, pn);
-            }
-        }
-    }
-    catch (const std::exception &e)
+    // From the shared index, rather than walking the embedded patches per instance
+    auto snap = index->snapshot();
+    for (const auto &e : snap->factory)
     {
-        SXSNLOG(e.what());
+        auto fn = e.path.filename().u8string();
+        factoryPatchNames[e.category].push_back(fn);
+        factoryPatchVector.emplace_back(e.category, fn);
     }
 
-    rescanUserPresets();
+    syncUserPresets();
 }
 
 PresetManager::~PresetManager() = default;
 
+void PresetManager::enablePrefetch()
+{
+    if (!prefetcher)
+        prefetcher = std::make_unique<PresetPrefetcher>();
+}
+
 void PresetManager::rescanUserPresets()
 {
+    index->requestRescan();
+    syncUserPresets();
+}
+
+bool PresetManager::syncUserPresets()
+{
+    auto g = index->generation();
+    if (g == indexGeneration)
+        return false;
+
+    auto snap = index->snapshot();
+    indexGeneration = g;
     userPatches.clear();
-    try
-    {
-        std::function<void(const fs::path &)> itd;
-        itd = [this, &itd](auto &p)
-        {
-            if (fs::is_directory(p))
-            {
-                for (auto &el : fs::directory_iterator(p))
-                {
-                    auto elp = el.path();
-                    if (elp.filename() == "." || elp.filename() == "..")
-                    {
-                        continue;
-                    }
-                    if (fs::is_directory(elp))
-                    {
-                        itd(elp);
-                    }
-                    else if (fs::is_regular_file(elp) && elp.extension() == ".sxsnp")
-                    {
-                        auto pushP = elp.lexically_relative(userPatchesPath);
-                        userPatches.push_back(pushP);
-                    }
-                }
-            }
-        };
-        itd(userPatchesPath);
-        std::sort(userPatches.begin(), userPatches.end(),
-                  [](const fs::path &a, const fs::path &b)
-                  {
-                      auto appe = a.parent_path().empty();
-                      auto bppe = b.parent_path().empty();
-
-                      if (appe && bppe)
-                      {
-                          return strnatcasecmp(a.filename().u8string().c_str(),
-                                               b.filename().u8string().c_str()) < 0;
-                      }
-                      else if (appe)
-                      {
-                          return true;
-                      }
-                      else if (bppe)
-                      {
-                          return false;
-                      }
-                      else
-                      {
-                          return a < b;
-                      }
-                  });
-    }
-    catch (fs::filesystem_error &)
-    {
-    }
+    userPatches.reserve(snap->user.size());
+    for (const auto &e : snap->user)
+        userPatches.push_back(e.path);
+    return true;
 }
 
 #if USE_WCHAR_PRESET
@@ -171,16 +116,30 @@ void PresetManager::saveUserPresetDirect(Patch &patch, const fs::path &pt)
 void PresetManager::loadUserPresetDirect(Patch &patch, Synth::mainToAudioQueue_T &mainToAudio,
                                          const fs::path &p)
 {
-    std::ifstream t(p);
-    if (!t.is_open())
-        return;
-    std::stringstream buffer;
-    buffer << t.rdbuf();
+    auto start = std::chrono::steady_clock::now();
+    auto req = PresetPrefetcher::userRequest(p);
+    auto hit = loadPrefetched(patch, req);
+    if (!hit)
+    {
+        std::ifstream t(p, std::ios::binary);
+        if (!t.is_open())
+            return;
+        std::stringstream buffer;
+        buffer << t.rdbuf();
 
-    patch.fromState(buffer.str());
+        patch.fromAnyState(buffer.str());
+    }
 
     auto dn = p.filename().replace_extension("").u8string();
     sendEntirePatchToAudio(patch, mainToAudio, dn);
+    if (prefetcher)
+    {
+        recordLoad(hit, start);
+        auto rel = p.lexically_relative(userPatchesPath);
+        auto it = std::find(userPatches.begin(), userPatches.end(), rel);
+        if (it != userPatches.end())
+            prefetchAround(factoryPatchVector.size() + (it - userPatches.begin()));
+    }
     if (onPresetLoaded)
         onPresetLoaded(dn);
 }
@@ -190,10 +149,15 @@ void PresetManager::loadFactoryPreset(Patch &patch, Synth::mainToAudioQueue_T &m
 {
     try
     {
-        auto fs = cmrc::sixsines_patches::get_filesystem();
-        auto f = fs.open(std::string() + factoryPath + "/" + cat + "/" + pat);
-        auto pb = std::string(f.begin(), f.end());
-        patch.fromState(pb);
+        auto start = std::chrono::steady_clock::now();
+        auto hit = loadPrefetched(patch, PresetPrefetcher::factoryRequest(cat, pat));
+        if (!hit)
+        {
+            auto fs = cmrc::sixsines_patches::get_filesystem();
+            auto f = fs.open(std::string() + factoryPath + "/" + cat + "/" + pat);
+            auto pb = std::string(f.begin(), f.end());
+            patch.fromAnyState(pb);
+        }
 
         // can we find this factory preset
         int idx{0};
@@ -215,6 +179,11 @@ void PresetManager::loadFactoryPreset(Patch &patch, Synth::mainToAudioQueue_T &m
             noExt = noExt.substr(0, ps);
         }
         sendEntirePatchToAudio(patch, mainToAudio, noExt);
+        if (prefetcher)
+        {
+            recordLoad(hit, start);
+            prefetchAround(idx);
+        }
 
         if (onPresetLoaded)
         {
@@ -227,6 +196,69 @@ void PresetManager::loadFactoryPreset(Patch &patch, Synth::mainToAudioQueue_T &m
     }
 }
 
+bool PresetManager::loadPrefetched(Patch &patch, const PresetPrefetcher::Request &req)
+{
+    if (!prefetcher)
+        return false;
+    auto img = prefetcher->take(req);
+    if (!img)
+        return false;
+    applyImage(patch, *img);
+    return true;
+}
+
+void PresetManager::recordLoad(bool hit, std::chrono::steady_clock::time_point start)
+{
+    auto ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+            .count();
+    if (hit)
+    {
+        prefetchStats.hits++;
+        prefetchStats.hitMs += ms;
+    }
+    else
+    {
+        prefetchStats.misses++;
+        prefetchStats.missMs += ms;
+    }
+}
+
+void PresetManager::applyImage(Patch &patch, const PatchImage &img)
+{
+    for (auto *q : patch.params)
+        q->value = img.values[q->index];
+    memset(patch.name, 0, sizeof(patch.name));
+    strncpy(patch.name, img.name, stringBufferLen - 1);
+    memset(patch.author, 0, sizeof(patch.author));
+    strncpy(patch.author, img.author, stringBufferLen - 1);
+    patch.macroNames = img.macroNames;
+}
+
+void PresetManager::prefetchAround(size_t at)
+{
+    // at indexes factoryPatchVector then userPatches, as the preset jog steps
+    auto total = factoryPatchVector.size() + userPatches.size();
+    auto requestFor = [this](size_t i)
+    {
+        if (i < factoryPatchVector.size())
+            return PresetPrefetcher::factoryRequest(factoryPatchVector[i].first,
+                                                    factoryPatchVector[i].second);
+        return PresetPrefetcher::userRequest(userPatchesPath /
+                                             userPatches[i - factoryPatchVector.size()]);
+    };
+
+    std::vector<PresetPrefetcher::Request> reqs;
+    for (int d = 1; d <= PresetPrefetcher::lookAround; ++d)
+    {
+        if (at + d < total)
+            reqs.push_back(requestFor(at + d));
+        if (at >= (size_t)d)
+            reqs.push_back(requestFor(at - d));
+    }
+    prefetcher->prefetch(std::move(reqs));
+}
+
 void PresetManager::loadInit(Patch &patch, Synth::mainToAudioQueue_T &mainToAudio)
 {
     patch.resetToInit();
@@ -257,51 +289,18 @@ void PresetManager::sendEntirePatchToAudio(Patch &patch, Synth::mainToAudioQueue
     {
         hostPar = static_cast<const clap_host_params_t *>(h->get_extension(h, CLAP_EXT_PARAMS));
     }
-    static char stringBuffer[stringBufferEntries][stringBufferLen];
-    static int currentString{0};
-
-    char *tmpDat = stringBuffer[currentString];
-    currentString = (currentString + 1) % stringBufferEntries;
-
-    memset(tmpDat, 0, stringBufferLen);
-    strncpy(tmpDat, name.c_str(), stringBufferLen - 1);
-    mainToAudio.push({Synth::MainToAudioMsg::SEND_PATCH_NAME, 0, 0.f, tmpDat});
-
-    char *authorDat = stringBuffer[currentString];
-    currentString = (currentString + 1) % stringBufferEntries;
-    memset(authorDat, 0, stringBufferLen);
-    auto authorStr = patch.getAuthor();
-    strncpy(authorDat, authorStr.c_str(), stringBufferLen - 1);
-    mainToAudio.push({Synth::MainToAudioMsg::SEND_PATCH_AUTHOR, 0, 0.f, authorDat});
-
-    // Each macro name uses its own slot in the rotating buffer so the pointer
-    // stays valid until the audio thread drains the queue.
-    for (uint32_t mi = 0; mi < numMacros; ++mi)
-    {
-        char *macDat = stringBuffer[currentString];
-        currentString = (currentString + 1) % stringBufferEntries;
-        memset(macDat, 0, stringBufferLen);
-        strncpy(macDat, patch.macroNames[mi].data(), stringBufferLen - 1);
-        Synth::MainToAudioMsg msg{Synth::MainToAudioMsg::SEND_MACRO_NAME};
-        msg.paramId = mi;
-        msg.uiManagedPointer = macDat;
-        mainToAudio.push(msg);
-    }
-    // The audio-side SEND_MACRO_NAME handler decides whether each name actually
-    // changed and requests an INFO rescan only if so (atomic-OR coalesces the
-    // burst into a single host call).
 
-    mainToAudio.push({Synth::MainToAudioMsg::STOP_AUDIO});
-    for (const auto &p : patch.params)
-    {
-        mainToAudio.push(
-            {Synth::MainToAudioMsg::SET_PARAM_WITHOUT_NOTIFYING, p->meta.id, p->value});
-    }
-    mainToAudio.push({Synth::MainToAudioMsg::START_AUDIO});
-    mainToAudio.push({Synth::MainToAudioMsg::SEND_PATCH_IS_CLEAN, true});
-    // SEND_POST_LOAD's audio handler now requests the VALUES rescan via
-    // Synth::requestParamRescan, so no separate rescan message is needed here.
-    mainToAudio.push({Synth::MainToAudioMsg::SEND_POST_LOAD, true});
+    // Build the wave tables this patch reads here, so the first notes don't play
+    // the audio thread's SIN fallback while the main thread builds them.
+    patch.prepareWaveTables();
+
+    // One message for the whole patch; the audio thread owns the image once it's
+    // popped and hands it back to Synth::onMainThread to free.
+    auto img = std::make_unique<PatchImage>(patch, name);
+    Synth::MainToAudioMsg msg{Synth::MainToAudioMsg::INSTALL_PATCH_IMAGE};
+    msg.dawExtraStatePointer = img.get();
+    if (mainToAudio.push(msg))
+        img.release();
 
     if (hostPar)
     {
@@ -21,6 +21,9 @@
 #include "sst/jucegui/data/Discrete.h"
 #include "synth/patch.h"
 #include "synth/synth.h"
+#include "presets/preset-index.h"
+#include "presets/preset-prefetch.h"
+#include <chrono>
 #include <map>
 #include <unordered_map>
 #include <functional>
@@ -40,7 +43,10 @@ struct PresetManager
     PresetManager(const clap_host_t *host);
     ~PresetManager();
 
+    // Asks the shared index for a rescan; userPatches follows when it lands
     void rescanUserPresets();
+    // Picks up a newer index snapshot into userPatches. Cheap when there isn't one
+    bool syncUserPresets();
 
     void loadInit(Patch &p, Synth::mainToAudioQueue_T &);
     void loadUserPresetDirect(Patch &, Synth::mainToAudioQueue_T &, const fs::path &p);
@@ -60,6 +66,23 @@ struct PresetManager
     std::vector<std::pair<std::string, std::string>> factoryPatchVector;
     std::vector<fs::path> userPatches;
 
+    std::shared_ptr<PresetIndex> index;
+    uint64_t indexGeneration{0};
+
+    // Only the editor's manager prefetches; the short lived ones the plugin and
+    // preset discovery make shouldn't start a thread
+    void enablePrefetch();
+    std::unique_ptr<PresetPrefetcher> prefetcher;
+    struct PrefetchStats
+    {
+        uint32_t hits{0}, misses{0};
+        double hitMs{0}, missMs{0}; // summed load times
+    } prefetchStats;
+    void prefetchAround(size_t at);
+    bool loadPrefetched(Patch &, const PresetPrefetcher::Request &);
+    void recordLoad(bool hit, std::chrono::steady_clock::time_point start);
+    static void applyImage(Patch &, const PatchImage &);
+
     const clap_host_params_t *clapHostParams{nullptr};
     void sendEntirePatchToAudio(Patch &, Synth::mainToAudioQueue_T &, const std::string &name);
     static void sendEntirePatchToAudio(Patch &, Synth::mainToAudioQueue_T &,
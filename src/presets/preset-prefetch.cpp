@@ -0,0 +1,167 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#include "preset-prefetch.h"
+#include <fstream>
+#include <sstream>
+
+#include "configuration.h"
+#include "presets/preset-manager.h"
+
+#include <cmrc/cmrc.hpp>
+
+CMRC_DECLARE(sixsines_patches);
+
+namespace baconpaul::six_sines::presets
+{
+PresetPrefetcher::PresetPrefetcher()
+{
+    worker = std::thread([this]() { run(); });
+}
+
+PresetPrefetcher::~PresetPrefetcher()
+{
+    {
+        auto lg = std::lock_guard(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    if (worker.joinable())
+        worker.join();
+}
+
+PresetPrefetcher::Request PresetPrefetcher::factoryRequest(const std::string &cat,
+                                                           const std::string &pat)
+{
+    Request r;
+    r.key = cat + "/" + pat;
+    r.factory = true;
+    r.cat = cat;
+    r.pat = pat;
+    return r;
+}
+
+PresetPrefetcher::Request PresetPrefetcher::userRequest(const fs::path &path)
+{
+    Request r;
+    r.key = path.u8string();
+    r.path = path;
+    std::error_code ec;
+    auto t = fs::last_write_time(path, ec);
+    if (!ec)
+        r.mtime = (int64_t)t.time_since_epoch().count();
+    auto sz = fs::file_size(path, ec);
+    if (!ec)
+        r.size = (uint64_t)sz;
+    return r;
+}
+
+std::shared_ptr<const PatchImage> PresetPrefetcher::take(const Request &r)
+{
+    auto lg = std::lock_guard(mutex);
+    auto it = findLocked(r);
+    if (it == lru.end())
+        return nullptr;
+    lru.splice(lru.begin(), lru, it);
+    return lru.front().image;
+}
+
+void PresetPrefetcher::prefetch(std::vector<Request> reqs)
+{
+    {
+        auto lg = std::lock_guard(mutex);
+        pending.clear();
+        for (auto &r : reqs)
+        {
+            auto it = findLocked(r);
+            if (it != lru.end())
+                lru.splice(lru.begin(), lru, it);
+            else
+                pending.push_back(std::move(r));
+        }
+    }
+    cv.notify_all();
+}
+
+std::list<PresetPrefetcher::Cached>::iterator PresetPrefetcher::findLocked(const Request &r)
+{
+    for (auto it = lru.begin(); it != lru.end(); ++it)
+        if (it->key == r.key && it->mtime == r.mtime && it->size == r.size)
+            return it;
+    return lru.end();
+}
+
+void PresetPrefetcher::run()
+{
+    auto scratch = std::make_unique<Patch>();
+
+    auto lk = std::unique_lock(mutex);
+    while (true)
+    {
+        cv.wait(lk, [this]() { return !pending.empty() || stopping; });
+        if (stopping)
+            break;
+
+        auto r = std::move(pending.front());
+        pending.pop_front();
+        if (findLocked(r) != lru.end())
+            continue;
+
+        lk.unlock();
+        auto img = parse(*scratch, r);
+        lk.lock();
+
+        if (!img)
+            continue;
+        lru.push_front({r.key, r.mtime, r.size, std::move(img)});
+        while (lru.size() > capacity)
+            lru.pop_back();
+    }
+}
+
+std::shared_ptr<const PatchImage> PresetPrefetcher::parse(Patch &scratch, const Request &r)
+{
+    try
+    {
+        std::string data;
+        if (r.factory)
+        {
+            auto rfs = cmrc::sixsines_patches::get_filesystem();
+            auto f = rfs.open(std::string() + PresetManager::factoryPath + "/" + r.cat + "/" +
+                              r.pat);
+            data = std::string(f.begin(), f.end());
+        }
+        else
+        {
+            std::ifstream t(r.path, std::ios::binary);
+            if (!t.is_open())
+                return nullptr;
+            std::stringstream buffer;
+            buffer << t.rdbuf();
+            data = buffer.str();
+        }
+
+        if (!scratch.fromAnyState(data))
+            return nullptr;
+        // The stored name, as fromState leaves it; the loader names the image it sends
+        return std::make_shared<const PatchImage>(scratch, scratch.name);
+    }
+    catch (const std::exception &e)
+    {
+        SXSNLOG("Preset prefetch failed " << e.what());
+    }
+    return nullptr;
+}
+} // namespace baconpaul::six_sines::presets
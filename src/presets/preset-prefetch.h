@@ -0,0 +1,91 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#ifndef BACONPAUL_SIX_SINES_PRESETS_PRESET_PREFETCH_H
+#define BACONPAUL_SIX_SINES_PRESETS_PRESET_PREFETCH_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "filesystem/import.h"
+#include "synth/patch.h"
+
+namespace baconpaul::six_sines::presets
+{
+/*
+ * Parses the presets either side of the one just loaded on a worker thread, so
+ * stepping through a list finds the next one already parsed.
+ *
+ * Each parsed preset is held as a PatchImage, keyed by "cat/pat" for factory
+ * presets and the absolute path for user ones, in a small LRU. A user entry also
+ * carries the file's mtime and size and is only used while they still match.
+ * Only the main thread calls into this; the worker owns its own scratch Patch.
+ */
+struct PresetPrefetcher
+{
+    static constexpr int lookAround{3};
+    static constexpr size_t capacity{2 * lookAround + 2};
+
+    struct Request
+    {
+        std::string key;
+        bool factory{false};
+        std::string cat, pat; // factory
+        fs::path path;        // user
+        int64_t mtime{0};
+        uint64_t size{0};
+    };
+
+    PresetPrefetcher();
+    ~PresetPrefetcher();
+
+    // The parsed image for this request, or null if it isn't ready
+    std::shared_ptr<const PatchImage> take(const Request &);
+
+    // Replaces whatever is still queued, nearest first
+    void prefetch(std::vector<Request> reqs);
+
+    static Request factoryRequest(const std::string &cat, const std::string &pat);
+    static Request userRequest(const fs::path &path);
+
+  protected:
+    struct Cached
+    {
+        std::string key;
+        int64_t mtime{0};
+        uint64_t size{0};
+        std::shared_ptr<const PatchImage> image;
+    };
+    std::list<Cached> lru; // most recently used first
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Request> pending;
+    bool stopping{false};
+    std::thread worker;
+
+    void run();
+    std::list<Cached>::iterator findLocked(const Request &);
+    static std::shared_ptr<const PatchImage> parse(Patch &scratch, const Request &);
+};
+} // namespace baconpaul::six_sines::presets
+#endif // BACONPAUL_SIX_SINES_PRESETS_PRESET_PREFETCH_H
@@ -0,0 +1,355 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#include "render-job.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+
+#include "sst/voicemanager/midi1_to_voicemanager.h"
+
+#include "synth/synth.h"
+#include "infra/RIFFWavWriter.h"
+
+namespace baconpaul::six_sines::render
+{
+namespace
+{
+bool isNoteOn(const TimedMidi &m) { return (m.data[0] & 0xF0) == 0x90 && m.data[2] > 0; }
+
+// Time order, and at a shared time note offs first so a repeated key retriggers
+void sortEvents(std::vector<TimedMidi> &ev)
+{
+    std::stable_sort(ev.begin(), ev.end(),
+                     [](const auto &a, const auto &b)
+                     {
+                         if (a.seconds != b.seconds)
+                             return a.seconds < b.seconds;
+                         return !isNoteOn(a) && isNoteOn(b);
+                     });
+}
+
+struct ByteReader
+{
+    const std::vector<uint8_t> &d;
+    size_t pos{0}, end{0};
+
+    bool overran{false}; // a read went past end, so the last value is not whole
+
+    bool done() const { return pos >= end; }
+    uint8_t u8()
+    {
+        if (pos < end)
+            return d[pos++];
+        overran = true;
+        return 0;
+    }
+    uint32_t be(int n)
+    {
+        uint32_t r{0};
+        for (int i = 0; i < n; ++i)
+            r = (r << 8) | u8();
+        return r;
+    }
+    uint32_t varLen()
+    {
+        uint32_t r{0};
+        for (int i = 0; i < 4; ++i)
+        {
+            auto b = u8();
+            r = (r << 7) | (b & 0x7F);
+            if (!(b & 0x80))
+                break;
+        }
+        return r;
+    }
+};
+} // namespace
+
+bool readMidiFile(const std::filesystem::path &p, std::vector<TimedMidi> &out, std::string &err)
+{
+    std::ifstream f(p, std::ios::binary);
+    if (!f.is_open())
+    {
+        err = "Unable to open '" + pathString(p) + "'";
+        return false;
+    }
+    std::vector<uint8_t> d((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    return readMidiBytes(d, pathString(p), out, err);
+}
+
+bool readMidiBytes(const std::vector<uint8_t> &d, const std::string &name,
+                   std::vector<TimedMidi> &out, std::string &err)
+{
+    ByteReader r{d, 0, d.size()};
+    auto magic = r.be(4);
+    auto headerLen = r.be(4);
+    if (magic != 0x4D546864 /* MThd */ || headerLen < 6 || d.size() < 8 + (size_t)headerLen)
+    {
+        err = "'" + name + "' is not a MIDI file";
+        return false;
+    }
+    r.be(2); // format; 0 and 1 read the same once tracks are merged
+    auto nTracks = r.be(2);
+    auto division = r.be(2);
+    if (division & 0x8000 || division == 0)
+    {
+        err = "SMPTE time MIDI files are not supported";
+        return false;
+    }
+    r.pos = 8 + headerLen;
+
+    struct TickEvent
+    {
+        uint64_t tick;
+        bool isTempo;
+        uint32_t tempo;
+        std::array<uint8_t, 3> data;
+    };
+    std::vector<TickEvent> ticks;
+
+    for (uint32_t t = 0; t < nTracks && !r.done(); ++t)
+    {
+        auto id = r.be(4);
+        auto len = r.be(4);
+        auto trackEnd = std::min(r.pos + (size_t)len, d.size());
+        if (id != 0x4D54726B /* MTrk */)
+        {
+            r.pos = trackEnd;
+            continue;
+        }
+
+        ByteReader tr{d, r.pos, trackEnd};
+        uint64_t tick{0};
+        uint8_t status{0};
+        while (!tr.done())
+        {
+            tick += tr.varLen();
+            auto b = tr.u8();
+            if (tr.overran)
+                break;
+            if (b == 0xFF)
+            {
+                auto type = tr.u8();
+                auto mlen = tr.varLen();
+                auto next = tr.pos + mlen;
+                if (type == 0x2F)
+                    break;
+                if (next > tr.end)
+                    break; // a chunk cut short in the file; keep what came before
+                if (type == 0x51 && mlen == 3)
+                    ticks.push_back({tick, true, tr.be(3), {}});
+                tr.pos = next;
+                continue;
+            }
+            if (b == 0xF0 || b == 0xF7)
+            {
+                tr.pos += tr.varLen();
+                continue;
+            }
+
+            uint8_t d1;
+            if (b & 0x80)
+            {
+                status = b;
+                d1 = tr.u8();
+            }
+            else
+            {
+                // running status
+                d1 = b;
+            }
+            if (status < 0x80)
+            {
+                err = "Malformed track in '" + name + "'";
+                return false;
+            }
+            auto kind = status & 0xF0;
+            uint8_t d2 = (kind == 0xC0 || kind == 0xD0) ? 0 : tr.u8();
+            if (tr.overran)
+                break;
+            ticks.push_back({tick, false, 0, {status, d1, d2}});
+        }
+        r.pos = trackEnd;
+    }
+
+    std::stable_sort(ticks.begin(), ticks.end(),
+                     [](const auto &a, const auto &b) { return a.tick < b.tick; });
+
+    // Walk the merged stream, accruing time at whichever tempo is current
+    double secondsPerTick = 0.5 / division; // 120bpm until told otherwise
+    double seconds{0};
+    uint64_t lastTick{0};
+    for (const auto &e : ticks)
+    {
+        seconds += (e.tick - lastTick) * secondsPerTick;
+        lastTick = e.tick;
+        if (e.isTempo)
+            secondsPerTick = e.tempo * 1e-6 / division;
+        else
+            out.push_back({seconds, e.data});
+    }
+    sortEvents(out);
+    return true;
+}
+
+bool readNoteScript(const std::filesystem::path &p, std::vector<TimedMidi> &out,
+                    std::string &err)
+{
+    std::ifstream f(p);
+    if (!f.is_open())
+    {
+        err = "Unable to open '" + pathString(p) + "'";
+        return false;
+    }
+    return readNoteScript(f, pathString(p), out, err);
+}
+
+bool readNoteScript(std::istream &in, const std::string &name, std::vector<TimedMidi> &out,
+                    std::string &err)
+{
+    std::string line;
+    int lineNo{0};
+    while (std::getline(in, line))
+    {
+        lineNo++;
+        auto first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+            continue;
+
+        std::istringstream ls(line);
+        double start, len;
+        int key, channel{0};
+        float vel{0.8f};
+        if (!(ls >> start >> len >> key) || start < 0 || len < 0 || key < 0 || key > 127)
+        {
+            err = name + ":" + std::to_string(lineNo) + ": expected 'start length key'";
+            return false;
+        }
+        if (ls >> vel)
+            ls >> channel;
+        auto ch = (uint8_t)std::clamp(channel, 0, 15);
+        auto v = (uint8_t)std::clamp((int)std::round(vel * 127), 1, 127);
+
+        out.push_back({start, {(uint8_t)(0x90 | ch), (uint8_t)key, v}});
+        out.push_back({start + len, {(uint8_t)(0x80 | ch), (uint8_t)key, 0}});
+    }
+    sortEvents(out);
+    return true;
+}
+
+RenderResult renderJob(const RenderJob &job)
+{
+    RenderResult res;
+
+    std::vector<TimedMidi> events;
+    auto ext = pathString(job.notes.extension());
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    auto read = (ext == ".mid" || ext == ".midi") ? readMidiFile : readNoteScript;
+    if (!read(job.notes, events, res.err))
+        return res;
+
+    std::ifstream t(job.patch, std::ios::binary);
+    if (!t.is_open())
+    {
+        res.err = "Unable to open '" + pathString(job.patch) + "'";
+        return res;
+    }
+    std::stringstream buffer;
+    buffer << t.rdbuf();
+    auto loaded = std::make_unique<Patch>();
+    if (!loaded->fromAnyState(buffer.str()))
+    {
+        res.err = "Unable to read patch '" + pathString(job.patch) + "'";
+        return res;
+    }
+
+    // Load it the way a preset load does, minus the queue
+    loaded->prepareWaveTables();
+    auto synth = std::make_unique<Synth>(false);
+    synth->setSampleRate(job.sampleRate);
+    synth->installPatchImage(new PatchImage(*loaded, pathString(job.patch.stem())));
+    synth->freeRetiredPatchImages();
+    if ((int)std::round(loaded->output.eventTiming.value) == ET_SAMPLE_ACCURATE)
+        synth->prepareStartDelayLines();
+
+    RIFFWavWriter wav(job.output, 2);
+    if (!wav.openFile())
+    {
+        res.err = wav.errMsg;
+        return res;
+    }
+    wav.writeRIFFHeader();
+    wav.writeFMTChunk((int32_t)job.sampleRate);
+    wav.startDataChunk();
+
+    const auto sr = job.sampleRate;
+    auto frameOf = [&](size_t i) { return (uint64_t)std::llround(events[i].seconds * sr); };
+    const uint64_t totalFrames =
+        (events.empty() ? 0 : frameOf(events.size() - 1)) + (uint64_t)(job.tailSeconds * sr);
+
+    static constexpr uint32_t hostFrames{512};
+    std::array<float, hostFrames> L, R;
+    std::array<float, 2 * hostFrames> interleaved;
+    float *outs[2]{L.data(), R.data()};
+
+    using clock = std::chrono::steady_clock;
+    clock::duration renderTime{0};
+    size_t next{0};
+    for (uint64_t pos = 0; pos < totalFrames; pos += hostFrames)
+    {
+        auto frames = (uint32_t)std::min<uint64_t>(hostFrames, totalFrames - pos);
+        auto t0 = clock::now();
+        synth->processBlock(frames, outs, nullptr, nullptr, nullptr,
+                            [&](uint32_t s)
+                            {
+                                while (next < events.size() && frameOf(next) <= pos + s)
+                                {
+                                    sst::voicemanager::applyMidi1Message(
+                                        *synth->voiceManager, 0, events[next].data.data());
+                                    next++;
+                                }
+                                if (next < events.size() && frameOf(next) < pos + frames)
+                                    return (uint32_t)(frameOf(next) - pos);
+                                return std::numeric_limits<uint32_t>::max();
+                            });
+        renderTime += clock::now() - t0;
+
+        for (uint32_t i = 0; i < frames; ++i)
+        {
+            interleaved[2 * i] = L[i];
+            interleaved[2 * i + 1] = R[i];
+        }
+        wav.pushInterleavedBlock(interleaved.data(), 2 * frames);
+    }
+
+    if (!wav.closeFile())
+    {
+        res.err = "Unable to finish writing '" + pathString(job.output) + "'";
+        return res;
+    }
+
+    res.ok = true;
+    res.audioSeconds = totalFrames / sr;
+    res.wallSeconds = std::chrono::duration<double>(renderTime).count();
+    return res;
+}
+} // namespace baconpaul::six_sines::render
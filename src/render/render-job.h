@@ -0,0 +1,86 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#ifndef BACONPAUL_SIX_SINES_RENDER_RENDER_JOB_H
+#define BACONPAUL_SIX_SINES_RENDER_RENDER_JOB_H
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace baconpaul::six_sines::render
+{
+/*
+ * A timed MIDI 1 channel message. Both note sources reduce to a list of these,
+ * which the renderer hands to the voice manager at the sample they fall on.
+ */
+struct TimedMidi
+{
+    double seconds{0};
+    std::array<uint8_t, 3> data{};
+};
+
+/*
+ * A standard MIDI file (format 0 or 1, metrical time) with all tracks merged and
+ * the tempo map applied. Meta and sysex events are dropped, and a track cut short
+ * keeps the events before the cut. Returns false and sets err if the file can't be
+ * read.
+ */
+bool readMidiFile(const std::filesystem::path &p, std::vector<TimedMidi> &out, std::string &err);
+// The same from the file's bytes; name is only used in err
+bool readMidiBytes(const std::vector<uint8_t> &bytes, const std::string &name,
+                   std::vector<TimedMidi> &out, std::string &err);
+
+/*
+ * A note list, one note per line as
+ *
+ *     <start seconds> <length seconds> <key> [velocity 0-1, default 0.8] [channel]
+ *
+ * Blank lines and lines starting with # are skipped.
+ */
+bool readNoteScript(const std::filesystem::path &p, std::vector<TimedMidi> &out,
+                    std::string &err);
+bool readNoteScript(std::istream &in, const std::string &name, std::vector<TimedMidi> &out,
+                    std::string &err);
+
+// A path as UTF-8 in a std::string, for messages; u8string is a u8string in C++20
+inline std::string pathString(const std::filesystem::path &p)
+{
+    auto u = p.u8string();
+    return std::string(u.begin(), u.end());
+}
+
+struct RenderJob
+{
+    std::filesystem::path patch, notes, output;
+    double sampleRate{48000};
+    double tailSeconds{2.0}; // rendered past the last event so releases ring out
+};
+
+struct RenderResult
+{
+    bool ok{false};
+    std::string err;
+    double audioSeconds{0}, wallSeconds{0};
+};
+
+// Builds its own Synth, so jobs may run on as many threads as you like
+RenderResult renderJob(const RenderJob &job);
+
+} // namespace baconpaul::six_sines::render
+#endif // RENDER_JOB_H
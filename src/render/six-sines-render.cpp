@@ -0,0 +1,186 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+/*
+ * six-sines-render: offline, faster than realtime rendering with no plugin host.
+ *
+ *   six-sines-render [options] <patch.sxsnp> <notes> <out.wav>
+ *   six-sines-render [options] --batch <jobs.txt>
+ *
+ * notes is a .mid/.midi file or a note list (see readNoteScript). A batch file
+ * has one "patch notes out.wav" job per line; jobs run in parallel with one
+ * Synth per thread. Every job reports its speed as a multiple of realtime, and a
+ * batch reports the aggregate, so this doubles as a throughput benchmark.
+ *
+ * Options: --sample-rate <hz> (48000), --tail <seconds> (2), --jobs <n> (all cores)
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dsp/sintable.h"
+#include "render/render-job.h"
+
+using namespace baconpaul::six_sines;
+using namespace baconpaul::six_sines::render;
+
+namespace
+{
+void usage()
+{
+    std::fprintf(stderr, "Usage: six-sines-render [--sample-rate hz] [--tail seconds] "
+                         "[--jobs n] <patch.sxsnp> <notes> <out.wav>\n"
+                         "       six-sines-render [options] --batch <jobs.txt>\n");
+}
+
+bool readBatch(const std::string &path, const RenderJob &proto, std::vector<RenderJob> &jobs)
+{
+    std::ifstream f(path);
+    if (!f.is_open())
+    {
+        std::fprintf(stderr, "Unable to open batch file '%s'\n", path.c_str());
+        return false;
+    }
+    std::string line;
+    while (std::getline(f, line))
+    {
+        auto first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+            continue;
+        std::istringstream ls(line);
+        std::string p, n, o;
+        if (!(ls >> p >> n >> o))
+        {
+            std::fprintf(stderr, "Bad batch line '%s'\n", line.c_str());
+            return false;
+        }
+        auto job = proto;
+        job.patch = p;
+        job.notes = n;
+        job.output = o;
+        jobs.push_back(job);
+    }
+    return true;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    RenderJob proto;
+    std::string batch;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> positional;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string a = argv[i];
+        auto hasValue = i + 1 < argc;
+        if (a == "--sample-rate" && hasValue)
+            proto.sampleRate = std::atof(argv[++i]);
+        else if (a == "--tail" && hasValue)
+            proto.tailSeconds = std::atof(argv[++i]);
+        else if (a == "--jobs" && hasValue)
+            threads = std::max(1, std::atoi(argv[++i]));
+        else if (a == "--batch" && hasValue)
+            batch = argv[++i];
+        else if (a.rfind("--", 0) == 0)
+        {
+            usage();
+            return 2;
+        }
+        else
+            positional.push_back(a);
+    }
+
+    std::vector<RenderJob> jobs;
+    if (!batch.empty())
+    {
+        if (!positional.empty() || !readBatch(batch, proto, jobs))
+        {
+            usage();
+            return 2;
+        }
+    }
+    else if (positional.size() == 3)
+    {
+        auto job = proto;
+        job.patch = positional[0];
+        job.notes = positional[1];
+        job.output = positional[2];
+        jobs.push_back(job);
+    }
+    else
+    {
+        usage();
+        return 2;
+    }
+    if (proto.sampleRate <= 0 || proto.tailSeconds < 0)
+    {
+        usage();
+        return 2;
+    }
+
+    // Build the shared tables before any worker constructs a Synth
+    SinTable::initializeStatics();
+
+    std::vector<RenderResult> results(jobs.size());
+    std::atomic<size_t> nextJob{0};
+    auto worker = [&]()
+    {
+        for (auto j = nextJob++; j < jobs.size(); j = nextJob++)
+            results[j] = renderJob(jobs[j]);
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    threads = std::min<int>(threads, (int)jobs.size());
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t)
+        pool.emplace_back(worker);
+    worker();
+    for (auto &t : pool)
+        t.join();
+    auto wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int failures{0};
+    double audio{0};
+    for (size_t j = 0; j < jobs.size(); ++j)
+    {
+        const auto &r = results[j];
+        if (!r.ok)
+        {
+            std::fprintf(stderr, "FAILED %s: %s\n", pathString(jobs[j].output).c_str(),
+                         r.err.c_str());
+            failures++;
+            continue;
+        }
+        audio += r.audioSeconds;
+        std::printf("%s audio=%.2fs render=%.3fs x_realtime=%.1f\n",
+                    pathString(jobs[j].output).c_str(), r.audioSeconds, r.wallSeconds,
+                    r.wallSeconds > 0 ? r.audioSeconds / r.wallSeconds : 0.0);
+    }
+    if (jobs.size() > 1)
+        std::printf("total jobs=%zu threads=%d audio=%.2fs wall=%.3fs x_realtime=%.1f\n",
+                    jobs.size(), threads, audio, wall, wall > 0 ? audio / wall : 0.0);
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,96 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#include "engine_stats.h"
+#include <string>
+#include <fmt/core.h>
+
+namespace baconpaul::six_sines
+{
+void EngineStats::addHostBlock(uint32_t fr, uint64_t ns, double load)
+{
+    add(hostBlocks, 1);
+    add(frames, fr);
+    add(hostNs, ns);
+    if (ns > maxHostBlockNs.load(std::memory_order_relaxed))
+        maxHostBlockNs.store(ns, std::memory_order_relaxed);
+    if (load > maxHostBlockLoad.load(std::memory_order_relaxed))
+        maxHostBlockLoad.store(load, std::memory_order_relaxed);
+    if (load >= xrunRiskLoad)
+        add(xrunRiskBlocks, 1);
+    if (load >= 1.0)
+        add(overrunBlocks, 1);
+}
+
+void EngineStats::clear()
+{
+    for (auto *a : {&hostBlocks, &engineBlocks, &frames, &hostNs, &maxHostBlockNs,
+                    &xrunRiskBlocks, &overrunBlocks})
+        a->store(0, std::memory_order_relaxed);
+    maxHostBlockLoad.store(0, std::memory_order_relaxed);
+    for (auto &a : stageNs)
+        a.store(0, std::memory_order_relaxed);
+    for (auto &a : voiceHistogram)
+        a.store(0, std::memory_order_relaxed);
+}
+
+EngineStats::Snapshot EngineStats::read() const
+{
+    Snapshot s;
+    s.hostBlocks = hostBlocks.load(std::memory_order_relaxed);
+    s.engineBlocks = engineBlocks.load(std::memory_order_relaxed);
+    s.frames = frames.load(std::memory_order_relaxed);
+    s.hostNs = hostNs.load(std::memory_order_relaxed);
+    s.maxHostBlockNs = maxHostBlockNs.load(std::memory_order_relaxed);
+    s.maxHostBlockLoad = maxHostBlockLoad.load(std::memory_order_relaxed);
+    s.xrunRiskBlocks = xrunRiskBlocks.load(std::memory_order_relaxed);
+    s.overrunBlocks = overrunBlocks.load(std::memory_order_relaxed);
+    for (int i = 0; i < numStages; ++i)
+        s.stageNs[i] = stageNs[i].load(std::memory_order_relaxed);
+    for (int i = 0; i < voiceBuckets; ++i)
+        s.voiceHistogram[i] = voiceHistogram[i].load(std::memory_order_relaxed);
+    return s;
+}
+
+void EngineStats::Snapshot::write(std::ostream &os) const
+{
+    static constexpr const char *stageNames[numStages]{"ui_queue", "voice_render",
+                                                       "end_of_chain", "resample"};
+
+    auto perBlock = [this](uint64_t ns) { return hostBlocks ? 1.0 * ns / hostBlocks : 0.0; };
+    auto pct = [this](uint64_t ns) { return hostNs ? 100.0 * ns / hostNs : 0.0; };
+
+    os << fmt::format("host_blocks {}\nengine_blocks {}\nframes {}\n", hostBlocks, engineBlocks,
+                      frames);
+    os << fmt::format("host_ns_per_block {:.0f}\nmax_host_block_ns {}\nmax_host_block_load "
+                      "{:.3f}\n",
+                      perBlock(hostNs), maxHostBlockNs, maxHostBlockLoad);
+    os << fmt::format("xrun_risk_blocks {}\noverrun_blocks {}\n", xrunRiskBlocks,
+                      overrunBlocks);
+    for (int i = 0; i < numStages; ++i)
+        os << fmt::format("stage {} ns_per_block {:.0f} pct {:.1f}\n", stageNames[i],
+                          perBlock(stageNs[i]), pct(stageNs[i]));
+    for (int i = 0; i < voiceBuckets; ++i)
+    {
+        auto lo = i == 0 ? 0 : 1 << (i - 1);
+        auto range = std::to_string(lo);
+        if (i == voiceBuckets - 1)
+            range += "+";
+        else if (i >= 2)
+            range += "-" + std::to_string(2 * lo - 1);
+        os << fmt::format("voices {} blocks {}\n", range, voiceHistogram[i]);
+    }
+}
+} // namespace baconpaul::six_sines
@@ -0,0 +1,146 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#ifndef BACONPAUL_SIX_SINES_SYNTH_ENGINE_STATS_H
+#define BACONPAUL_SIX_SINES_SYNTH_ENGINE_STATS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace baconpaul::six_sines
+{
+/*
+ * Where an instance's audio thread time goes, kept whether or not an editor is
+ * open so a slow session can be looked at after the fact.
+ *
+ * Only the audio thread writes, so each counter is a relaxed load and store rather
+ * than a locked add, and nothing here allocates. Any other thread may read() at any
+ * time; the counters are individually consistent but may be a block apart from one
+ * another. reset() only raises a flag, and the audio thread clears the counters at
+ * the start of its next host block.
+ *
+ * A clock read costs tens of nanoseconds, a real share of an 8 sample engine block
+ * on a light patch, so the per engine block stages are timed on one engine block in
+ * stageSampleEvery and that block's time is counted for all of them. The host block
+ * time and UI_QUEUE, read once per host block, are exact.
+ */
+struct EngineStats
+{
+    using clock_t = std::chrono::high_resolution_clock;
+
+    enum Stage
+    {
+        UI_QUEUE,     // draining the main to audio queue, once per host block
+        VOICE_RENDER, // rendering and summing the voices
+        END_OF_CHAIN, // processEndOfBlock
+        RESAMPLE,     // engine rate to host rate
+        numStages
+    };
+
+    // Engine blocks by voice count: 0, 1, 2-3, 4-7, ... 32-63, 64 and up
+    static constexpr int voiceBuckets{8};
+
+    // A host block using this much of its realtime counts as at risk of an xrun
+    static constexpr double xrunRiskLoad{0.8};
+
+    static constexpr uint32_t defaultStageSampleEvery{8};
+
+    struct Snapshot
+    {
+        uint64_t hostBlocks{0}, engineBlocks{0}, frames{0};
+        uint64_t hostNs{0}, maxHostBlockNs{0};
+        double maxHostBlockLoad{0};
+        uint64_t xrunRiskBlocks{0}, overrunBlocks{0};
+        std::array<uint64_t, numStages> stageNs{};
+        std::array<uint64_t, voiceBuckets> voiceHistogram{};
+
+        void write(std::ostream &) const;
+    };
+
+    Snapshot read() const;
+    void reset() { resetRequested.store(true, std::memory_order_relaxed); }
+
+    // Audio thread
+    void beginHostBlock()
+    {
+        if (resetRequested.exchange(false, std::memory_order_relaxed))
+            clear();
+    }
+    void addHostStage(Stage s, clock_t::time_point from, clock_t::time_point to)
+    {
+        add(stageNs[s], nanos(from, to));
+    }
+    void addEngineBlock(int voiceCount)
+    {
+        auto n = engineBlocks.load(std::memory_order_relaxed);
+        timingStages = stageSampleEvery > 0 && n % stageSampleEvery == 0;
+        add(engineBlocks, 1);
+        add(voiceHistogram[bucketFor(voiceCount)], 1);
+    }
+    // For the stages of the engine block last passed to addEngineBlock: the time now
+    // if that block is timed, and no clock read otherwise
+    clock_t::time_point stageMark() const
+    {
+        return timingStages ? clock_t::now() : clock_t::time_point{};
+    }
+    void addEngineStage(Stage s, clock_t::time_point from, clock_t::time_point to)
+    {
+        if (timingStages)
+            add(stageNs[s], stageSampleEvery * nanos(from, to));
+    }
+    void addHostBlock(uint32_t frames, uint64_t ns, double load);
+
+    // 1 times every engine block, 0 none (the perf scenarios compare them)
+    void setStageSampleEvery(uint32_t every) { stageSampleEvery = every; }
+
+    static int bucketFor(int voiceCount)
+    {
+        int b{0};
+        while (voiceCount > 0 && b < voiceBuckets - 1)
+        {
+            voiceCount >>= 1;
+            b++;
+        }
+        return b;
+    }
+    static uint64_t nanos(clock_t::time_point from, clock_t::time_point to)
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+    }
+
+  protected:
+    static void add(std::atomic<uint64_t> &a, uint64_t v)
+    {
+        a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+    }
+    void clear();
+
+    std::atomic<uint64_t> hostBlocks{0}, engineBlocks{0}, frames{0};
+    std::atomic<uint64_t> hostNs{0}, maxHostBlockNs{0};
+    std::atomic<double> maxHostBlockLoad{0};
+    std::atomic<uint64_t> xrunRiskBlocks{0}, overrunBlocks{0};
+    std::array<std::atomic<uint64_t>, numStages> stageNs{};
+    std::array<std::atomic<uint64_t>, voiceBuckets> voiceHistogram{};
+    std::atomic<bool> resetRequested{false};
+
+    // Audio thread only
+    uint32_t stageSampleEvery{defaultStageSampleEvery};
+    bool timingStages{false};
+};
+} // namespace baconpaul::six_sines
+#endif // BACONPAUL_SIX_SINES_SYNTH_ENGINE_STATS_H
@@ -16,6 +16,8 @@
 #ifndef BACONPAUL_SIX_SINES_SYNTH_MATRIX_INDEX_H
 #define BACONPAUL_SIX_SINES_SYNTH_MATRIX_INDEX_H
 
+#include <cassert>
+#include <mutex>
 #include <stddef.h>
 #include "configuration.h"
 
@@ -28,37 +30,40 @@ struct MatrixIndex
     static inline size_t positionMatrix[numOps][numOps];
 
     static inline bool tablesInitialized{false};
+    static inline std::once_flag tablesOnce;
+
+    // Called from every Patch and Synth ctor, so possibly from several threads at once
     static bool initialize()
     {
-        if (tablesInitialized)
-            return tablesInitialized;
-        tablesInitialized = true;
-        {
-            int idx{0};
-            for (int t = 1; t < numOps; ++t)
-            {
-                for (int s = 0; s < t; ++s)
-                {
-                    sourceTable[idx] = s;
-                    targetTable[idx] = t;
-                    idx++;
-                }
-            }
-        }
+        std::call_once(tablesOnce,
+                       []()
+                       {
+                           int idx{0};
+                           for (int t = 1; t < numOps; ++t)
+                           {
+                               for (int s = 0; s < t; ++s)
+                               {
+                                   sourceTable[idx] = s;
+                                   targetTable[idx] = t;
+                                   idx++;
+                               }
+                           }
 
-        for (int i = 0; i < numOps; ++i)
-        {
-            for (int j = 0; j < numOps; ++j)
-            {
-                positionMatrix[i][j] = matrixSize + 1;
-            }
-        }
-        for (int i = 0; i < matrixSize; ++i)
-        {
-            auto s = sourceTable[i];
-            auto t = targetTable[i];
-            positionMatrix[s][t] = i;
-        }
+                           for (int i = 0; i < numOps; ++i)
+                           {
+                               for (int j = 0; j < numOps; ++j)
+                               {
+                                   positionMatrix[i][j] = matrixSize + 1;
+                               }
+                           }
+                           for (int i = 0; i < matrixSize; ++i)
+                           {
+                               auto s = sourceTable[i];
+                               auto t = targetTable[i];
+                               positionMatrix[s][t] = i;
+                           }
+                           tablesInitialized = true;
+                       });
         return tablesInitialized;
     }
 
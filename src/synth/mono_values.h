@@ -67,6 +67,24 @@ struct MonoValues
     bool attackFloorOnRetrig{true};
     bool designModeRunAll{false};
 
+    // Bumped by Synth whenever a param changes or glides. Anything derived only
+    // from params (Voice routing) compares it to redo that work only when it has to.
+    uint32_t paramVersion{0};
+
+    // Bumped only when a param is set or a glide settles, not on every block of the
+    // glide, for caches which can wait out a glide at their old value: an idle
+    // LFO's checkLfoUsed and the step LFO's copy of its steps.
+    uint32_t paramSetVersion{0};
+
+    // Lets a held envelope keep last block's output and the step LFO skip copying
+    // unchanged steps. Only the tests and perf scenarios clear it, to check the
+    // output is bit identical either way and to time the difference.
+    bool reuseHeldBlocks{true};
+
+    // Set by Synth when someone reads per-op output (the multi-out buses or the op
+    // VU meters), so OutputNode::renderBlock fills its opOutput.
+    bool renderOpOutputs{false};
+
     std::array<float *, numMacros> macroPtr;
 
     MTSClient *mtsClient{nullptr};
@@ -88,6 +106,12 @@ struct MonoValues
     float unisonPanScalar{0.f};
 
     float audioInBlock alignas(16)[blockSize]{}; // engine-rate audio in, mono mix
+
+    // With sample accurate event timing, Synth::processBlock sets this to the
+    // engine-rate delay which puts the event being dispatched on its exact sample,
+    // and a voice attacked by that event holds back its output by this many
+    // samples. Zero otherwise.
+    int32_t voiceStartDelay{0};
 };
 }; // namespace baconpaul::six_sines
 #endif // MONO_VALUES_H
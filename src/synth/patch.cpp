@@ -14,9 +14,34 @@
  */
 
 #include "patch.h"
+#include <cassert>
+#include <cstdint>
+#include <string_view>
 namespace baconpaul::six_sines
 {
 
+void Patch::buildIdIndex()
+{
+    assert(params.size() < noParam);
+    uint32_t maxId{0};
+    for (const auto *p : params)
+        maxId = std::max(maxId, p->meta.id);
+
+    idPageOf.assign((maxId >> idPageBits) + 1, noParam);
+    idPages.clear();
+    for (const auto *p : params)
+    {
+        auto &pg = idPageOf[p->meta.id >> idPageBits];
+        if (pg == noParam)
+        {
+            pg = (uint16_t)idPages.size();
+            idPages.emplace_back();
+            idPages.back().fill(noParam);
+        }
+        idPages[pg][p->meta.id & (idPageSize - 1)] = (uint16_t)p->index;
+    }
+}
+
 void Patch::setupAdditionalState()
 {
     onResetToInit = [](Patch &p)
@@ -81,7 +106,7 @@ float Patch::migrateParamValueFromVersion(Param *p, float value, uint32_t versio
          * This is a gross way to do this but really its just to not break
          * Jacky's patches from the very first weekend, so...
          */
-        static auto oldStyle = md_t().asFloat().asLog2SecondsRange(
+        static const auto oldStyle = md_t().asFloat().asLog2SecondsRange(
             sst::basic_blocks::modulators::TenSecondRange::etMin,
             sst::basic_blocks::modulators::TenSecondRange::etMax);
         if (value < oldStyle.minVal + 0.0001)
@@ -214,4 +239,198 @@ void Patch::migratePatchFromVersion(uint32_t version)
     }
 }
 
+namespace
+{
+struct BinaryReader
+{
+    const char *data;
+    size_t size, pos{0};
+
+    bool read(void *to, size_t n)
+    {
+        if (n > size - pos)
+            return false;
+        memcpy(to, data + pos, n);
+        pos += n;
+        return true;
+    }
+    bool readU32(uint32_t &v) { return read(&v, sizeof(v)); }
+    // A length prefixed string into a fixed buffer, truncated to fit
+    bool readString(char *to, size_t cap)
+    {
+        uint32_t len;
+        if (!readU32(len) || len > size - pos)
+            return false;
+        auto n = std::min((size_t)len, cap - 1);
+        memcpy(to, data + pos, n);
+        to[n] = 0;
+        pos += len;
+        return true;
+    }
+};
+
+void appendU32(std::string &s, uint32_t v) { s.append((const char *)&v, sizeof(v)); }
+void appendString(std::string &s, const char *c, size_t len)
+{
+    appendU32(s, (uint32_t)len);
+    s.append(c, len);
+}
+} // namespace
+
+bool Patch::isBinaryState(const char *data, size_t size)
+{
+    return size >= sizeof(binaryMagic) && memcmp(data, binaryMagic, sizeof(binaryMagic)) == 0;
+}
+
+std::string Patch::toBinaryState(bool withDawExtraState) const
+{
+    uint32_t changed{0};
+    for (const auto *p : params)
+        if (p->value != p->meta.defaultVal)
+            changed++;
+
+    std::string res;
+    res.reserve(1024 + changed * 2 * sizeof(uint32_t));
+    res.append(binaryMagic, sizeof(binaryMagic));
+    appendU32(res, binaryFormatVersion);
+    appendU32(res, patchVersion);
+
+    appendString(res, name, strnlen(name, stringBufferLen));
+    appendString(res, author, strnlen(author, stringBufferLen));
+    appendU32(res, numMacros);
+    for (const auto &m : macroNames)
+        appendString(res, m.data(), strnlen(m.data(), m.size()));
+
+    appendU32(res, changed);
+    for (const auto *p : params)
+    {
+        if (p->value == p->meta.defaultVal)
+            continue;
+        appendU32(res, p->meta.id);
+        res.append((const char *)&p->value, sizeof(float));
+    }
+
+    std::string extra;
+    if (withDawExtraState && dawExtraStateTo)
+    {
+        TiXmlElement e("dawExtraState");
+        dawExtraStateTo(e);
+        TiXmlPrinter printer;
+        e.Accept(&printer);
+        extra = printer.Str();
+    }
+    appendString(res, extra.data(), extra.size());
+    return res;
+}
+
+bool Patch::fromBinaryState(const char *data, size_t size)
+{
+    if (!isBinaryState(data, size))
+        return false;
+
+    BinaryReader r{data, size, sizeof(binaryMagic)};
+    uint32_t format, version;
+    if (!r.readU32(format) || format > binaryFormatVersion || !r.readU32(version))
+        return false;
+
+    resetToInit();
+
+    if (!r.readString(name, stringBufferLen) || !r.readString(author, stringBufferLen))
+        return false;
+    uint32_t nMacros;
+    if (!r.readU32(nMacros))
+        return false;
+    for (uint32_t i = 0; i < nMacros; ++i)
+    {
+        char discard[64];
+        if (!r.readString(i < numMacros ? macroNames[i].data() : discard, 64))
+            return false;
+    }
+
+    uint32_t changed;
+    if (!r.readU32(changed))
+        return false;
+    for (uint32_t i = 0; i < changed; ++i)
+    {
+        uint32_t id;
+        float value;
+        if (!r.readU32(id) || !r.read(&value, sizeof(value)))
+            return false;
+        // An id this build doesn't have is from a newer one; skip it as XML does
+        if (auto *p = paramById(id))
+            p->value = migrateParamValueFromVersion(p, value, version);
+    }
+    migratePatchFromVersion(version);
+
+    uint32_t extraLen;
+    if (!r.readU32(extraLen) || extraLen > size - r.pos)
+        return false;
+    if (extraLen > 0 && dawExtraStateFrom)
+    {
+        TiXmlDocument doc;
+        doc.Parse(std::string(data + r.pos, extraLen).c_str());
+        if (auto *e = doc.FirstChildElement("dawExtraState"))
+            dawExtraStateFrom(*e);
+    }
+    return true;
+}
+
+void Patch::prepareWaveTables() const
+{
+    for (const auto &sn : sourceNodes)
+    {
+        SinTable::prepareWaveForm((SinTable::WaveForm)std::round(sn.waveForm.value));
+
+        using RW = SourceNode::ResonantSweepWindow;
+        auto rw =
+            static_cast<RW>(static_cast<uint32_t>(std::round(sn.resonantSweepWindowShape.value)));
+        if (rw == RW::BLACKMAN_HARRIS)
+            SinTable::prepareWaveForm(SinTable::BLACKMAN_HARRIS_WINDOW);
+        else if (rw == RW::TUKEY)
+            SinTable::prepareWaveForm(SinTable::TUKEY_WINDOW);
+    }
+}
+
+bool Patch::readStateInfo(const char *data, size_t size, std::string &name,
+                          std::string &author)
+{
+    if (isBinaryState(data, size))
+    {
+        // The strings follow the magic, format version and patch version
+        BinaryReader r{data, size, sizeof(binaryMagic) + 2 * sizeof(uint32_t)};
+        char buf[stringBufferLen];
+        if (!r.readString(buf, stringBufferLen))
+            return false;
+        name = buf;
+        if (!r.readString(buf, stringBufferLen))
+            return false;
+        author = buf;
+        return true;
+    }
+
+    // Parse the root element on its own rather than the whole document
+    auto sv = std::string_view(data, size);
+    auto start = sv.find("<patch");
+    if (start == std::string_view::npos)
+        return false;
+    auto end = sv.find('>', start);
+    if (end == std::string_view::npos)
+        return false;
+    auto root = std::string(sv.substr(start, end - start));
+    if (!root.empty() && root.back() == '/')
+        root.pop_back();
+    root += "/>";
+
+    TiXmlDocument doc;
+    doc.Parse(root.c_str());
+    auto *e = doc.FirstChildElement("patch");
+    if (!e)
+        return false;
+    auto *n = e->Attribute("name");
+    auto *a = e->Attribute("author");
+    name = n ? n : "";
+    author = a ? a : "";
+    return true;
+}
+
 } // namespace baconpaul::six_sines
\ No newline at end of file
@@ -21,6 +21,7 @@
 #include <unordered_map>
 #include <algorithm>
 #include <string>
+#include <cstring>
 #include <clap/clap.h>
 #include "configuration.h"
 #include "sst/cpputils/constructors.h"
@@ -70,6 +71,9 @@ struct Param : pats::ParamBase, sst::cpputils::active_set_overlay<Param>::partic
     Param *tempoSyncPartner{nullptr};
 
     sst::basic_blocks::dsp::LinearLag<float, false> lag;
+    float lagTarget{0.f}; // where lag is heading, which is what a state save writes
+
+    uint32_t index{0}; // position in Patch::params
 };
 
 struct Patch : pats::PatchBase<Patch, Param>
@@ -93,6 +97,10 @@ struct Patch : pats::PatchBase<Patch, Param>
     static constexpr uint64_t version_120e = 0x010205;
     // Sixth chunk of 1.2.0: pink-noise extended mode
     static constexpr uint64_t version_120f = 0x010206;
+    // Seventh chunk of 1.2.0: sample accurate event timing
+    static constexpr uint64_t version_120g = 0x010207;
+    // Eighth chunk of 1.2.0: adaptive operator render rate
+    static constexpr uint64_t version_120h = 0x010208;
 
     static md_t baseMd(uint64_t version = version_110) { return md_t().withVersion(version); }
     static md_t floatMd(uint64_t version = version_110)
@@ -172,12 +180,36 @@ struct Patch : pats::PatchBase<Patch, Param>
 
                       return a->meta.name < b->meta.name;
                   });
+        for (size_t i = 0; i < params.size(); ++i)
+            params[i]->index = (uint32_t)i;
+        buildIdIndex();
 
         setupAdditionalState();
     }
 
     void setupAdditionalState();
 
+    /*
+     * paramMap.at for the audio thread, with no hashing. Ids are sparse (each node
+     * family has its own idBase and stride) but clustered, so they live in a two
+     * level table: the id's high bits pick a page of 256 slots and its low bits a
+     * slot, which holds the param's index. The populated pages come to a few KB.
+     */
+    static constexpr uint32_t idPageBits{8}, idPageSize{1 << idPageBits};
+    static constexpr uint16_t noParam{0xFFFF};
+    std::vector<uint16_t> idPageOf;
+    std::vector<std::array<uint16_t, idPageSize>> idPages;
+    void buildIdIndex();
+
+    Param *paramById(uint32_t id) const
+    {
+        auto pg = id >> idPageBits;
+        if (pg >= idPageOf.size() || idPageOf[pg] == noParam)
+            return nullptr;
+        auto ix = idPages[idPageOf[pg]][id & (idPageSize - 1)];
+        return ix == noParam ? nullptr : params[ix];
+    }
+
     struct LFOMixin
     {
         enum Shape
@@ -1729,7 +1761,8 @@ struct Patch : pats::PatchBase<Patch, Param>
                                  .withName(name() + " Resampler Engine")
                                  .withGroupName(name())
                                  .withDefault(ResamplerEngine::SRC_FAST)
-                                 .withRange(ResamplerEngine::SRC_FAST, ResamplerEngine::ZOH)
+                                 .withRange(ResamplerEngine::SRC_FAST,
+                                            ResamplerEngine::INT_DECIMATE)
                                  .withID(id(41))
                                  .withUnorderedMapFormatting({
                                      {ResamplerEngine::SRC_FAST, "SRC Fast (rec)"},
@@ -1738,6 +1771,7 @@ struct Patch : pats::PatchBase<Patch, Param>
                                      {ResamplerEngine::LANCZOS, "Lanczos A=4"},
                                      {ResamplerEngine::LINTERP, "Linear Interp"},
                                      {ResamplerEngine::ZOH, "ZOH"},
+                                     {ResamplerEngine::INT_DECIMATE, "Integer FIR"},
                                  })),
               saturationType(intMd(version_120e)
                                  .withName(name() + " Saturation Type")
@@ -1821,6 +1855,26 @@ struct Patch : pats::PatchBase<Patch, Param>
                              .withName(name() + " Output Gain")
                              .withGroupName(name())
                              .withID(id(56))),
+              eventTiming(intMd(version_120g)
+                              .withName(name() + " Event Timing")
+                              .withGroupName(name())
+                              .withDefault(EventTiming::ET_BLOCK)
+                              .withRange(EventTiming::ET_BLOCK, EventTiming::ET_SAMPLE_ACCURATE)
+                              .withID(id(57))
+                              .withUnorderedMapFormatting({
+                                  {EventTiming::ET_BLOCK, "Block"},
+                                  {EventTiming::ET_SAMPLE_ACCURATE, "Sample Accurate"},
+                              })),
+              opRenderRate(intMd(version_120h)
+                               .withName(name() + " Operator Render Rate")
+                               .withGroupName(name())
+                               .withDefault(OpRenderRate::ORR_FULL)
+                               .withRange(OpRenderRate::ORR_FULL, OpRenderRate::ORR_ADAPTIVE)
+                               .withID(id(58))
+                               .withUnorderedMapFormatting({
+                                   {OpRenderRate::ORR_FULL, "Full"},
+                                   {OpRenderRate::ORR_ADAPTIVE, "Adaptive"},
+                               })),
               unisonPan(floatMd()
                             .withName(name() + " Unison Stereo Field")
                             .asPercent()
@@ -1864,6 +1918,7 @@ struct Patch : pats::PatchBase<Patch, Param>
         Param saturationType, saturationDrive;
         Param lowpass, bitRateAdjust, bitDepthAdjust, highpass;
         Param outputGain;
+        Param eventTiming, opRenderRate;
 
         std::array<Param, numModsPer> modtarget;
 
@@ -1899,7 +1954,9 @@ struct Patch : pats::PatchBase<Patch, Param>
                                      &bitRateAdjust,
                                      &bitDepthAdjust,
                                      &highpass,
-                                     &outputGain};
+                                     &outputGain,
+                                     &eventTiming,
+                                     &opRenderRate};
             appendDAHDSRParams(res);
 
             for (int i = 0; i < numModsPer; ++i)
@@ -1928,6 +1985,60 @@ struct Patch : pats::PatchBase<Patch, Param>
 
     float migrateParamValueFromVersion(Param *p, float value, uint32_t version);
     void migratePatchFromVersion(uint32_t version);
+
+    /*
+     * Compact binary state: a header, the patch strings, then only the params that
+     * differ from their default, as (id, value) pairs, and the DAW extra state if
+     * asked for. Loading is a resetToInit and a paramById per stored param, with no
+     * XML parse and no allocation per param. stateSave writes this; the XML from
+     * toState stays the preset file and import / export format, and the loaders
+     * take either through fromAnyState.
+     *
+     * Values are stored in host byte order, which is little endian everywhere we
+     * build. Bump binaryFormatVersion if the layout changes; patchVersion still
+     * drives param migration as it does for XML.
+     */
+    static constexpr char binaryMagic[4]{'S', 'X', 'S', 'B'};
+    static constexpr uint32_t binaryFormatVersion{1};
+    static bool isBinaryState(const char *data, size_t size);
+    std::string toBinaryState(bool withDawExtraState) const;
+    bool fromBinaryState(const char *data, size_t size);
+    // Just the name and author of a state in either form, without building a Patch
+    static bool readStateInfo(const char *data, size_t size, std::string &name,
+                              std::string &author);
+    bool fromAnyState(const std::string &data)
+    {
+        if (isBinaryState(data.data(), data.size()))
+            return fromBinaryState(data.data(), data.size());
+        return fromState(data);
+    }
+
+    // Main thread; builds the wave tables the sources read, since the audio thread
+    // never builds one (see SinTable::setWaveForm)
+    void prepareWaveTables() const;
+};
+
+/*
+ * A whole preset as the audio thread takes it on load: every value by Param::index
+ * plus the patch strings. It is built on the main thread and handed over as one
+ * pointer (MainToAudioMsg::INSTALL_PATCH_IMAGE) rather than a message per param,
+ * and comes back to the main thread to be freed (see Synth::installPatchImage).
+ */
+struct PatchImage
+{
+    PatchImage(const Patch &p, const std::string &patchName) : values(p.params.size())
+    {
+        for (const auto *q : p.params)
+            values[q->index] = q->value;
+        strncpy(name, patchName.c_str(), stringBufferLen - 1);
+        strncpy(author, p.author, stringBufferLen - 1);
+        macroNames = p.macroNames;
+    }
+
+    std::vector<float> values;
+    char name[stringBufferLen]{};
+    char author[stringBufferLen]{};
+    std::array<std::array<char, 64>, numMacros> macroNames{};
 };
 } // namespace baconpaul::six_sines
 #endif // PATCH_H
@@ -45,8 +45,14 @@ Synth::Synth(bool mo)
     patch.dawExtraStateTo = [this](TiXmlElement &e) { toDawExtraState(e); };
     patch.dawExtraStateFrom = [this](TiXmlElement &e) { fromDawExtraState(e); };
 
-    std::fill(lState.begin(), lState.end(), nullptr);
-    std::fill(rState.begin(), rState.end(), nullptr);
+    for (auto &b : streamBuffers)
+        b.values.resize(patch.params.size());
+    streamPatch = std::make_unique<Patch>();
+    streamPatch->dawExtraStateTo = [this](TiXmlElement &e) { toDawExtraState(e); };
+
+    // Voices are built back to back, so their clock-seeded generators can collide
+    for (auto &v : voices)
+        v.voiceValues.rng.reseed(monoValues.rng.unifU32());
 
     reapplyControlSettings();
     resetSoloState();
@@ -76,17 +82,16 @@ Synth::Synth(bool mo)
 
 Synth::~Synth()
 {
+    freeRetiredPatchImages();
+    delete unretiredPatchImage;
+
     if (monoValues.mtsClient)
     {
         MTS_DeregisterClient(monoValues.mtsClient);
     }
 
-    for (auto ls : lState)
-        if (ls)
-            src_delete(ls);
-    for (auto rs : rState)
-        if (rs)
-            src_delete(rs);
+    if (srcState)
+        src_delete(srcState);
 }
 
 void Synth::toDawExtraState(TiXmlElement &e) const
@@ -173,11 +178,22 @@ void Synth::setSampleRate(double sampleRate)
     }
     sampleRateRatio = hostSampleRate / engineSampleRate;
 
+    useDecimator = false;
+    useIntDecimator = false;
     if (usesLanczos())
     {
         for (int i = 0; i < (isMultiOut ? (1 + numOps) : 1); ++i)
             resampler[i] = std::make_unique<resampler_t>((float)monoValues.sr.sampleRate,
                                                          (float)hostSampleRate);
+
+        auto hostRate = std::llround(hostSampleRate);
+        if (resamplerEngine == LANCZOS && std::fabs(hostSampleRate - hostRate) < 1e-6)
+        {
+            if (!decimator)
+                decimator = std::make_unique<decimator_t>();
+            useDecimator = decimator->setRates(std::llround(engineSampleRate), hostRate,
+                                               isMultiOut ? 2 * (1 + numOps) : 2);
+        }
     }
     else
     {
@@ -191,22 +207,22 @@ void Synth::setSampleRate(double sampleRate)
             mode = SRC_SINC_BEST_QUALITY;
         }
 
-        for (int i = 0; i < (isMultiOut ? (1 + numOps) : 1); ++i)
+        if (srcState)
         {
-            if (lState[i])
-            {
-                src_delete(lState[i]);
-            }
-            if (rState[i])
-            {
-                src_delete(rState[i]);
-            }
-            int ec;
+            src_delete(srcState);
+        }
+        int ec;
+        srcChannels = isMultiOut ? 2 * (1 + numOps) : 2;
+        srcState = src_new(mode, srcChannels, &ec);
+        src_set_ratio(srcState, sampleRateRatio);
 
-            lState[i] = src_new(mode, 1, &ec);
-            rState[i] = src_new(mode, 1, &ec);
-            src_set_ratio(lState[i], sampleRateRatio);
-            src_set_ratio(rState[i], sampleRateRatio);
+        auto hostRate = std::llround(hostSampleRate);
+        if (resamplerEngine == INT_DECIMATE && std::fabs(hostSampleRate - hostRate) < 1e-6)
+        {
+            if (!intDecimator)
+                intDecimator = std::make_unique<intDecimator_t>();
+            useIntDecimator = intDecimator->setRates(std::llround(engineSampleRate), hostRate,
+                                                     srcChannels);
         }
     }
 
@@ -223,6 +239,10 @@ void Synth::setSampleRate(double sampleRate)
     }
     paramLagSet.removeAll();
 
+    engineLead = 0;
+    engineLeadFloor = 0;
+    engineLeadKnown = false;
+
     // midi is a bit less frequent than param automation so a slightly slower smooth
     midiCCLagCollection.setRateInMilliseconds(1000.0 * 128.0 / 48000.0, engineSampleRate,
                                               1.0 / blockSize);
@@ -237,26 +257,174 @@ void Synth::setSampleRate(double sampleRate)
     reapplyControlSettings();
 }
 
-template <bool multiOut> void Synth::processInternal(const clap_output_events_t *outq)
+void Synth::prepareStartDelayLines()
+{
+    if (startDelayStorage)
+        return;
+    startDelayStorage = std::make_unique<Voice::StartDelayLines[]>(voices.size());
+    startDelayPool.store(startDelayStorage.get(), std::memory_order_release);
+}
+
+bool Synth::startDelayLinesReady()
 {
-    auto start = std::chrono::high_resolution_clock::now();
-    if (!SinTable::staticsInitialized)
-        SinTable::initializeStatics();
+    if (startDelayLinesWired)
+        return true;
+
+    auto *pool = startDelayPool.load(std::memory_order_acquire);
+    if (!pool)
+    {
+        if (!startDelayLinesRequested.exchange(true) && clapHost)
+            clapHost->request_callback(clapHost);
+        return false;
+    }
+    for (size_t i = 0; i < voices.size(); ++i)
+        voices[i].startDelayLines = &pool[i];
+    startDelayLinesWired = true;
+    return true;
+}
 
+void Synth::beginHostBlock(const clap_output_events_t *outq)
+{
+    stats.beginHostBlock();
+    hostBlockStart = std::chrono::high_resolution_clock::now();
     processUIQueue(outq);
+    stats.addHostStage(EngineStats::UI_QUEUE, hostBlockStart,
+                       std::chrono::high_resolution_clock::now());
+}
 
+void Synth::endHostBlock(uint32_t frames)
+{
+    // A voice found its wave table unbuilt and is reading SIN until the main
+    // thread has built it in onMainThread
+    if (SinTable::takeBuildRequestsPosted() && clapHost)
+        clapHost->request_callback(clapHost);
+
+    if (frames == 0)
+        return;
+
+    // Finish CPU calculation. The smoothing is per blockSize host samples, so
+    // scale the factor to cover however many frames this call spanned.
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - hostBlockStart);
+    auto micros = duration.count();
+    auto availmicrosinv = hostSampleRate * 1e-9 / frames;
+    auto pct = micros * availmicrosinv;
+    stats.addHostBlock(frames, (uint64_t)micros, pct);
+
+    auto cpuFac = frames == blockSize ? 0.995 : std::pow(0.995, 1.0 * frames / blockSize);
+    cpuUsage = cpuUsage * cpuFac + pct * (1 - cpuFac);
+
+    auto budget = cpuBudget.load(std::memory_order_relaxed);
+    if (budget > 0)
+        applyCpuBudget(pct, frames, budget);
+}
+
+void Synth::applyCpuBudget(double load, uint32_t frames, float budget)
+{
+    // The load is wall clock time, so one block the OS descheduled or page faulted
+    // can read many times realtime. Smoothing over a window and then asking for a
+    // whole window over budget keeps a spike like that from shedding anything.
+    auto window = hostSampleRate * budgetWindowSeconds;
+    budgetLoad += std::min(1.0, frames / window) * (load - budgetLoad);
+
+    if (budgetHoldoffFrames > 0)
+    {
+        budgetHoldoffFrames -= frames;
+        return;
+    }
+    if (budgetLoad <= budget)
+    {
+        budgetOverFrames = 0;
+        return;
+    }
+    budgetOverFrames += frames;
+    if (budgetOverFrames < window)
+        return;
+
+    int live{0}, releasing{0};
+    for (auto v = head; v; v = v->next)
+    {
+        // Voices an earlier shed chose still count towards the load until they
+        // have faded, so wait for them before deciding again. Anything else
+        // fading (a steal, say) is on its way out and just isn't counted.
+        if (v->shedForCpu)
+            return;
+        if (v->fadeBlocks >= 0)
+            continue;
+        live++;
+        if (!v->voiceValues.gated)
+            releasing++;
+    }
+    if (live == 0)
+        return;
+
+    auto keep = (int)std::floor(live * budget / budgetLoad);
+    auto n = std::min(std::max(1, live - keep), std::max(1, live / budgetMaxShedDivisor));
+    if (releasing > 0)
+        n = std::min(n, releasing);
+    shedVoices(n);
+
+    budgetOverFrames = 0;
+    budgetHoldoffFrames = window;
+}
+
+int Synth::shedVoices(int n)
+{
+    auto level = [](const Voice *v)
+    {
+        float res{0};
+        for (int i = 0; i < blockSize; ++i)
+            res += std::fabs(v->output[0][i]) + std::fabs(v->output[1][i]);
+        return res;
+    };
+
+    int shed{0};
+    for (; shed < n; ++shed)
+    {
+        Voice *quietest{nullptr};
+        bool qReleasing{false};
+        float qLevel{0};
+        for (auto v = head; v; v = v->next)
+        {
+            if (v->fadeBlocks >= 0)
+                continue;
+            auto releasing = !v->voiceValues.gated;
+            auto l = level(v);
+            if (!quietest || (releasing && !qReleasing) ||
+                (releasing == qReleasing && l < qLevel))
+            {
+                quietest = v;
+                qReleasing = releasing;
+                qLevel = l;
+            }
+        }
+        if (!quietest)
+            break;
+        responder.terminateVoice(quietest);
+        quietest->shedForCpu = true;
+    }
+    voicesShed += shed;
+    return shed;
+}
+
+template <bool multiOut> void Synth::processInternal(const clap_output_events_t *outq)
+{
     if (!audioRunning)
     {
         memset(output, 0, sizeof(output));
+        if (streamSnapshotDirty)
+            publishStreamSnapshot();
         return;
     }
 
     for (auto it = paramLagSet.begin(); it != paramLagSet.end();)
     {
+        monoValues.paramVersion++;
         it->lag.process();
         it->value = it->lag.v;
         if (!it->lag.isActive())
         {
+            monoValues.paramSetVersion++;
             it = paramLagSet.erase(it);
         }
         else
@@ -268,6 +436,7 @@ template <bool multiOut> void Synth::processInternal(const clap_output_events_t
     midiCCLagCollection.processAll();
 
     monoValues.attackFloorOnRetrig = patch.output.attackFloorOnRetrig > 0.5;
+    monoValues.renderOpOutputs = multiOut || isEditorAttached;
 
     int loops{0};
 
@@ -275,7 +444,11 @@ template <bool multiOut> void Synth::processInternal(const clap_output_events_t
 
     int generated{0};
 
-    if (usesLanczos())
+    if (useDecimator)
+        generated = decimator->canProduce(blockSize) ? blockSize : 0;
+    else if (useIntDecimator)
+        generated = intDecimator->canProduce(blockSize) ? blockSize : 0;
+    else if (usesLanczos())
         generated = (resampler[0]->inputsRequiredToGenerateOutputs(blockSize) > 0 ? 0 : blockSize);
 
     std::array<bool, numOps> mixerActive;
@@ -287,7 +460,13 @@ template <bool multiOut> void Synth::processInternal(const clap_output_events_t
     while (generated < blockSize)
     {
         loops++;
+        engineLead += blockSize;
+        auto uiLagging = lagHandler.active;
+        if (uiLagging)
+            monoValues.paramVersion++;
         lagHandler.process();
+        if (uiLagging && !lagHandler.active)
+            monoValues.paramSetVersion++;
 
         // Hoist mono unison params so per-voice renderBlock derives uniRatioMul / uniPanShift
         // from the smoothed scalars without each voice repeating the twoToTheX lookup.
@@ -323,38 +502,77 @@ template <bool multiOut> void Synth::processInternal(const clap_output_events_t
         float lOutput alignas(16)[2 * (1 + (multiOut ? numOps : 0))][blockSize];
         memset(lOutput, 0, sizeof(lOutput));
 
+        // Per-op sums for the VU meters; multi-out meters its op buses instead
+        float opVuBus alignas(16)[multiOut ? 1 : numOps][2][blockSize];
+        if (!multiOut && isEditorAttached)
+            memset(opVuBus, 0, sizeof(opVuBus));
+
+        stats.addEngineBlock(voiceCount);
+        auto voiceStart = stats.stageMark();
+
+        auto rendered = packVoicesForRender;
+        if (renderPool.threadCount() > 1 && voiceCount >= renderThreadsVoiceThreshold)
+        {
+            renderListCount = 0;
+            for (auto pv = head; pv; pv = pv->next)
+                renderList[renderListCount++] = pv;
+
+            auto items = renderListCount;
+            if (packVoicesForRender)
+                items = (renderListCount + SinTable::lanes - 1) / SinTable::lanes;
+            renderPool.run(&Synth::renderListItem, this, items);
+            rendered = true;
+        }
+        else if (packVoicesForRender)
+        {
+            Voice *pack[SinTable::lanes];
+            int np{0};
+            for (auto pv = head; pv; pv = pv->next)
+            {
+                pack[np++] = pv;
+                if (np == SinTable::lanes)
+                {
+                    renderVoicePack(pack, np);
+                    np = 0;
+                }
+            }
+            if (np)
+                renderVoicePack(pack, np);
+        }
+
         auto cvoice = head;
         Voice *removeVoice{nullptr};
 
         while (cvoice)
         {
             assert(cvoice->used);
-            cvoice->renderBlock();
+            if (!rendered)
+                cvoice->renderBlock();
 
             mech::accumulate_from_to<blockSize>(cvoice->output[0], lOutput[0]);
             mech::accumulate_from_to<blockSize>(cvoice->output[1], lOutput[1]);
 
+            const auto opMask = cvoice->out.opOutputMask;
+            const auto &opOut = cvoice->out.opOutput;
             if constexpr (multiOut)
             {
-                // TODO if voice active check
-                float stp[2][blockSize];
                 for (int i = 0; i < numOps; ++i)
                 {
-                    if (!cvoice->mixerNode[i].active)
-                    {
-                        continue;
-                    }
-                    if (!cvoice->mixerNode[i].from.operatorOutputsToOp)
-                    {
+                    if (!(opMask & (1u << i)) || !cvoice->mixerNode[i].from.operatorOutputsToOp)
                         continue;
-                    }
                     mixerActive[i] = true;
-                    mech::mul_block<blockSize>(cvoice->out.finalEnvLevel,
-                                               cvoice->mixerNode[i].output[0], stp[0]);
-                    mech::mul_block<blockSize>(cvoice->out.finalEnvLevel,
-                                               cvoice->mixerNode[i].output[1], stp[1]);
-                    mech::accumulate_from_to<blockSize>(stp[0], lOutput[2 + 2 * i]);
-                    mech::accumulate_from_to<blockSize>(stp[1], lOutput[2 + 2 * i + 1]);
+                    mech::accumulate_from_to<blockSize>(opOut[i][0], lOutput[2 + 2 * i]);
+                    mech::accumulate_from_to<blockSize>(opOut[i][1], lOutput[2 + 2 * i + 1]);
+                }
+            }
+            else if (isEditorAttached)
+            {
+                for (int i = 0; i < numOps; ++i)
+                {
+                    if (!(opMask & (1u << i)))
+                        continue;
+                    mech::accumulate_from_to<blockSize>(opOut[i][0], opVuBus[i][0]);
+                    mech::accumulate_from_to<blockSize>(opOut[i][1], opVuBus[i][1]);
                 }
             }
 
@@ -380,11 +598,27 @@ template <bool multiOut> void Synth::processInternal(const clap_output_events_t
             assert(!v->next && !v->prior);
         }
 
+        auto eocStart = stats.stageMark();
+        stats.addEngineStage(EngineStats::VOICE_RENDER, voiceStart, eocStart);
+
         // End-of-chain stages run on the main engine-rate stereo bus,
         // before downsampling. Per-op buses in multiOut are not processed yet.
         processEndOfBlock(lOutput[0], lOutput[1]);
 
-        if (usesLanczos())
+        auto resampleStart = stats.stageMark();
+        stats.addEngineStage(EngineStats::END_OF_CHAIN, eocStart, resampleStart);
+
+        if (useDecimator)
+        {
+            decimator->push(lOutput);
+            generated = decimator->canProduce(blockSize) ? blockSize : 0;
+        }
+        else if (useIntDecimator)
+        {
+            intDecimator->push(lOutput);
+            generated = intDecimator->canProduce(blockSize) ? blockSize : 0;
+        }
+        else if (usesLanczos())
         {
             if constexpr (multiOut)
             {
@@ -408,63 +642,40 @@ template <bool multiOut> void Synth::processInternal(const clap_output_events_t
         }
         else
         {
-            int gen0{0};
-            for (int rsi = 0; rsi < (multiOut ? (numOps + 1) : 1); ++rsi)
-            {
-                d.data_in = lOutput[2 * rsi];
-                d.data_out = output[2 * rsi] + generated;
-                d.input_frames = blockSize;
-                d.output_frames = blockSize - generated;
-                d.end_of_input = 0;
-                d.src_ratio = sampleRateRatio;
-
-                src_process(lState[rsi], &d);
-                auto lgen = d.output_frames_gen;
-
-                d.data_in = lOutput[2 * rsi + 1];
-                d.data_out = output[2 * rsi + 1] + generated;
-                d.input_frames = blockSize;
-                d.output_frames = blockSize - generated;
-                d.end_of_input = 0;
-                d.src_ratio = sampleRateRatio;
-
-                src_process(rState[rsi], &d);
-                auto rgen = d.output_frames_gen;
-                assert(lgen == rgen);
-                if (rsi == 0)
-                {
-                    gen0 = lgen;
-                }
-            }
-            generated += gen0;
+            static constexpr int maxCh{2 * (1 + numOps)};
+            float srcIn[blockSize * maxCh], srcOut[blockSize * maxCh];
+            const int nCh = srcChannels;
+            assert(nCh == 2 * (1 + (multiOut ? numOps : 0)));
+            for (int i = 0; i < blockSize; ++i)
+                for (int c = 0; c < nCh; ++c)
+                    srcIn[i * nCh + c] = lOutput[c][i];
+
+            d.data_in = srcIn;
+            d.data_out = srcOut;
+            d.input_frames = blockSize;
+            d.output_frames = blockSize - generated;
+            d.end_of_input = 0;
+            d.src_ratio = sampleRateRatio;
+            src_process(srcState, &d);
+
+            for (int i = 0; i < d.output_frames_gen; ++i)
+                for (int c = 0; c < nCh; ++c)
+                    output[c][generated + i] = srcOut[i * nCh + c];
+            generated += d.output_frames_gen;
         }
+        stats.addEngineStage(EngineStats::RESAMPLE, resampleStart, stats.stageMark());
 
         if (isEditorAttached)
         {
-            float stp[numOps][2][blockSize];
-            memset(stp, 0, sizeof(stp));
-            auto cvoice = head;
-            while (cvoice)
-            {
-                for (int i = 0; i < numOps; ++i)
-                {
-                    if (!cvoice->mixerNode[i].active)
-                    {
-                        continue;
-                    }
-                    mech::mul_block<blockSize>(cvoice->out.finalEnvLevel,
-                                               cvoice->mixerNode[i].output[0], stp[i][0]);
-                    mech::mul_block<blockSize>(cvoice->out.finalEnvLevel,
-                                               cvoice->mixerNode[i].output[1], stp[i][1]);
-                }
-                cvoice = cvoice->next;
-            }
             for (int i = 0; i < blockSize; ++i)
             {
                 vuPeak.process(lOutput[0][i], lOutput[1][i]);
                 for (int j = 0; j < numOps; ++j)
                 {
-                    opVuPeak[j].process(stp[j][0][i], stp[j][1][i]);
+                    if constexpr (multiOut)
+                        opVuPeak[j].process(lOutput[2 + 2 * j][i], lOutput[3 + 2 * j][i]);
+                    else
+                        opVuPeak[j].process(opVuBus[j][0][i], opVuBus[j][1][i]);
                 }
             }
 
@@ -479,7 +690,8 @@ template <bool multiOut> void Synth::processInternal(const clap_output_events_t
                     audioToUi.push(smsg);
                 }
 
-                AudioToUIMsg msg2{AudioToUIMsg::UPDATE_VOICE_COUNT, (uint32_t)voiceCount};
+                AudioToUIMsg msg2{AudioToUIMsg::UPDATE_VOICE_COUNT, (uint32_t)voiceCount,
+                                  (float)voicesShed.load(std::memory_order_relaxed)};
                 audioToUi.push(msg2);
 
                 AudioToUIMsg msg3{AudioToUIMsg::UPDATE_CPU_USAGE, 0, (float)(cpuUsage * 100)};
@@ -498,7 +710,18 @@ template <bool multiOut> void Synth::processInternal(const clap_output_events_t
         }
     }
 
-    if (resamplerEngine == LANCZOS)
+    auto produceStart = stats.stageMark();
+    if (useDecimator || useIntDecimator)
+    {
+        float *outs[2 * (1 + numOps)];
+        for (int c = 0; c < 2 * (1 + (multiOut ? numOps : 0)); ++c)
+            outs[c] = output[c];
+        if (useDecimator)
+            decimator->produce(outs, blockSize);
+        else
+            intDecimator->produce(outs, blockSize);
+    }
+    else if (resamplerEngine == LANCZOS)
     {
         if constexpr (multiOut)
         {
@@ -546,6 +769,14 @@ template <bool multiOut> void Synth::processInternal(const clap_output_events_t
             resampler[0]->renormalizePhases();
         }
     }
+    stats.addEngineStage(EngineStats::RESAMPLE, produceStart, stats.stageMark());
+
+    // The loop above stops as soon as the resampler can fill the host block, so
+    // from here the lead sits within a block of its floor; see processBlock.
+    engineLead -= blockSize / sampleRateRatio;
+    if (!engineLeadKnown || engineLead < engineLeadFloor)
+        engineLeadFloor = engineLead;
+    engineLeadKnown = true;
 
     if (isEditorAttached)
     {
@@ -554,19 +785,71 @@ template <bool multiOut> void Synth::processInternal(const clap_output_events_t
         {
             audioOutputRing.push(output[0], output[1], blockSize);
         }
+    }
 
-        // Finish CPU calculation
-        auto end = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
-        auto micros = duration.count();
-        auto availmicrosinv = hostSampleRate * 1e-9 / blockSize;
-        auto pct = micros * availmicrosinv;
-        auto cpuFac = 0.995;
-        cpuUsage = cpuUsage * cpuFac + pct * (1 - cpuFac);
+    if (streamSnapshotDirty)
+        publishStreamSnapshot();
+}
+
+void Synth::publishStreamSnapshot()
+{
+    auto idx = streamPublished.load(std::memory_order_relaxed) == 0 ? 1 : 0;
+    auto &b = streamBuffers[idx];
+    auto seq = b.seq.load(std::memory_order_relaxed);
+    b.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (const auto *p : patch.params)
+        b.values[p->index] = p->lag.isActive() ? p->lagTarget : p->value;
+    if (lagHandler.active && uiLagParam)
+        b.values[uiLagParam->index] = uiLagTarget;
+    memcpy(b.name, patch.name, sizeof(b.name));
+    memcpy(b.author, patch.author, sizeof(b.author));
+    b.macroNames = patch.macroNames;
+
+    b.seq.store(seq + 2, std::memory_order_release);
+    streamPublished.store(idx, std::memory_order_release);
+    streamSnapshotDirty = false;
+}
+
+Patch &Synth::patchForStream()
+{
+    auto &sp = *streamPatch;
+    for (int attempt = 0; attempt < 64; ++attempt)
+    {
+        auto idx = streamPublished.load(std::memory_order_acquire);
+        if (idx < 0)
+            return patch;
+
+        const auto &b = streamBuffers[idx];
+        auto seq = b.seq.load(std::memory_order_acquire);
+        if (seq & 1)
+            continue;
+
+        for (auto *p : sp.params)
+            p->value = b.values[p->index];
+        memcpy(sp.name, b.name, sizeof(sp.name));
+        memcpy(sp.author, b.author, sizeof(sp.author));
+        sp.macroNames = b.macroNames;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (b.seq.load(std::memory_order_relaxed) == seq)
+            return sp;
     }
+    // Only reachable if the audio thread republishes faster than we can copy,
+    // in which case the last copy is close enough to be worth saving.
+    SXSNLOG("Stream snapshot kept changing under the copy; saving the last attempt");
+    return sp;
 }
 
 void Synth::process(const clap_output_events_t *o)
+{
+    beginHostBlock(o);
+    processEngineBlock(o);
+    endHostBlock(blockSize);
+}
+
+void Synth::processEngineBlock(const clap_output_events_t *o)
 {
     if (isMultiOut)
         processInternal<true>(o);
@@ -574,6 +857,71 @@ void Synth::process(const clap_output_events_t *o)
         processInternal<false>(o);
 }
 
+void Synth::renderListItem(void *synth, int item)
+{
+    auto &s = *static_cast<Synth *>(synth);
+    if (s.packVoicesForRender)
+    {
+        auto from = item * SinTable::lanes;
+        auto n = std::min(SinTable::lanes, s.renderListCount - from);
+        s.renderVoicePack(&s.renderList[from], n);
+    }
+    else
+    {
+        s.renderList[item]->renderBlock();
+    }
+}
+
+void Synth::setRenderThreads(int n)
+{
+    requestedRenderThreads = std::clamp(n, 1, VoiceRenderPool::maxUsefulThreads());
+    renderPool.setThreadCount(requestedRenderThreads);
+}
+
+void Synth::renderVoicePack(Voice *const *pack, int n)
+{
+    assert(n > 0 && n <= SinTable::lanes);
+
+    for (int v = 0; v < n; ++v)
+        pack[v]->beginBlock();
+
+    for (int i = 0; i < numOps; ++i)
+    {
+        OpSource *ops[SinTable::lanes];
+        float rf[SinTable::lanes], dRF[SinTable::lanes];
+        bool opActive[SinTable::lanes];
+        int nops{0};
+
+        for (int v = 0; v < n; ++v)
+        {
+            opActive[v] = pack[v]->prepareOp(i);
+            if (!opActive[v])
+                continue;
+
+            auto &s = pack[v]->src[i];
+            if (s.canRenderPacked())
+            {
+                if (s.beginBlock(rf[nops], dRF[nops]))
+                    ops[nops++] = &s;
+            }
+            else
+            {
+                s.renderBlock();
+            }
+        }
+
+        if (nops)
+            OpSource::renderPacked(ops, nops, rf, dRF);
+
+        for (int v = 0; v < n; ++v)
+            if (opActive[v])
+                pack[v]->mixerNode[i].renderBlock();
+    }
+
+    for (int v = 0; v < n; ++v)
+        pack[v]->endBlock();
+}
+
 void Synth::addToVoiceList(Voice *v)
 {
     v->prior = nullptr;
@@ -669,7 +1017,9 @@ void Synth::processUIQueue(const clap_output_events_t *outq)
         {
             bool notify = uiM->action == MainToAudioMsg::SET_PARAM;
 
-            auto dest = patch.paramMap.at(uiM->paramId);
+            auto dest = patch.paramById(uiM->paramId);
+            if (!dest)
+                break;
             if (notify)
             {
                 if (beginEndParamGestureCount == 0)
@@ -677,9 +1027,15 @@ void Synth::processUIQueue(const clap_output_events_t *outq)
                     SXSNLOG("Non-begin/end bound param edit for '" << dest->meta.name << "'");
                 }
                 if (dest->meta.type == md_t::FLOAT)
+                {
                     lagHandler.setNewDestination(&(dest->value), uiM->value);
+                    uiLagParam = dest;
+                    uiLagTarget = uiM->value;
+                }
                 else
+                {
                     dest->value = uiM->value;
+                }
 
                 clap_event_param_value_t p;
                 p.header.size = sizeof(clap_event_param_value_t);
@@ -756,11 +1112,13 @@ void Synth::processUIQueue(const clap_output_events_t *outq)
             memset(patch.name, 0, sizeof(patch.name));
             strncpy(patch.name, uiM->uiManagedPointer, 255);
             audioToUi.push({AudioToUIMsg::SET_PATCH_NAME, 0, 0, 0, patch.name});
+            streamSnapshotDirty = true;
         }
         break;
         case MainToAudioMsg::SEND_PATCH_AUTHOR:
         {
             patch.setAuthor(uiM->uiManagedPointer ? uiM->uiManagedPointer : "");
+            streamSnapshotDirty = true;
         }
         break;
         case MainToAudioMsg::SEND_MACRO_NAME:
@@ -780,6 +1138,7 @@ void Synth::processUIQueue(const clap_output_events_t *outq)
                     out.patchNamePointer = buf.data();
                     audioToUi.push(out);
                     pendingRescan |= RescanRequest::INFO;
+                    streamSnapshotDirty = true;
                 }
             }
         }
@@ -797,6 +1156,14 @@ void Synth::processUIQueue(const clap_output_events_t *outq)
             pendingRescan |= RescanRequest::VALUES;
         }
         break;
+        case MainToAudioMsg::INSTALL_PATCH_IMAGE:
+        {
+            auto *img =
+                static_cast<PatchImage *>(const_cast<void *>(uiM->dawExtraStatePointer));
+            if (img)
+                pendingRescan |= installPatchImage(img);
+        }
+        break;
         case MainToAudioMsg::SEND_PREP_FOR_STREAM:
         {
             prepForStream();
@@ -815,9 +1182,27 @@ void Synth::processUIQueue(const clap_output_events_t *outq)
         case MainToAudioMsg::SET_DESIGN_MODE_RUN_ALL:
         {
             monoValues.designModeRunAll = uiM->value > 0.5;
+            monoValues.paramVersion++;
             voiceManager->allSoundsOff();
         }
         break;
+        case MainToAudioMsg::SET_RENDER_THREADS:
+        {
+            // The pool spawns and joins threads, so hand the change to the main thread
+            requestedRenderThreads =
+                std::clamp((int)uiM->value, 1, VoiceRenderPool::maxUsefulThreads());
+            if (clapHost)
+                clapHost->request_callback(clapHost);
+        }
+        break;
+        case MainToAudioMsg::SET_CPU_BUDGET:
+        {
+            cpuBudget = std::max(uiM->value, 0.f);
+            budgetLoad = 0;
+            budgetOverFrames = 0;
+            budgetHoldoffFrames = 0;
+        }
+        break;
         case MainToAudioMsg::SET_DAW_EXTRA_STATE:
         {
             auto *p = static_cast<const DawExtraState *>(uiM->dawExtraStatePointer);
@@ -1059,7 +1444,9 @@ void Synth::handleParamValue(Param *p, uint32_t pid, float value)
 {
     if (!p)
     {
-        p = patch.paramMap.at(pid);
+        p = patch.paramById(pid);
+        if (!p)
+            return;
     }
 
     // Mirror the UI path (SET_PARAM): only FLOATs lag; discrete params snap so
@@ -1067,6 +1454,7 @@ void Synth::handleParamValue(Param *p, uint32_t pid, float value)
     if (p->meta.type == md_t::FLOAT)
     {
         p->lag.setTarget(value);
+        p->lagTarget = value;
         paramLagSet.addToActive(p);
     }
     else
@@ -1082,6 +1470,10 @@ void Synth::handleParamValue(Param *p, uint32_t pid, float value)
 
 void Synth::handleAudioThreadParamSideEffects(Param *dest)
 {
+    monoValues.paramVersion++;
+    monoValues.paramSetVersion++;
+    streamSnapshotDirty = true;
+
     if (dest->meta.id == patch.output.playMode.meta.id ||
         dest->meta.id == patch.output.polyLimit.meta.id ||
         dest->meta.id == patch.output.pianoModeActive.meta.id ||
@@ -1134,6 +1526,14 @@ void Synth::resetSoloState()
 
 void Synth::onMainThread()
 {
+    freeRetiredPatchImages();
+    SinTable::serviceBuildRequests();
+    if (startDelayLinesRequested.load(std::memory_order_acquire))
+        prepareStartDelayLines();
+
+    if (requestedRenderThreads != renderPool.threadCount())
+        renderPool.setThreadCount(requestedRenderThreads);
+
     auto flags = onMainRescanFlags.exchange(0, std::memory_order_acquire);
     if (flags == 0 || !clapHost)
         return;
@@ -1148,6 +1548,67 @@ void Synth::onMainThread()
         pe->rescan(clapHost, CLAP_PARAM_RESCAN_INFO);
 }
 
+uint32_t Synth::installPatchImage(PatchImage *img)
+{
+    if (lagHandler.active)
+        lagHandler.instantlySnap();
+    voiceManager->allSoundsOff();
+    for (auto it = paramLagSet.begin(); it != paramLagSet.end();)
+        it = paramLagSet.erase(it);
+
+    if (img->values.size() == patch.params.size())
+    {
+        for (auto *p : patch.params)
+        {
+            p->value = img->values[p->index];
+            p->lagTarget = p->value;
+        }
+    }
+
+    memcpy(patch.name, img->name, sizeof(patch.name));
+    audioToUi.push({AudioToUIMsg::SET_PATCH_NAME, 0, 0, 0, patch.name});
+    memcpy(patch.author, img->author, sizeof(patch.author));
+
+    uint32_t rescan{0};
+    for (uint32_t mi = 0; mi < numMacros; ++mi)
+    {
+        auto &buf = patch.macroNames[mi];
+        if (std::strncmp(buf.data(), img->macroNames[mi].data(), buf.size()) != 0)
+        {
+            buf = img->macroNames[mi];
+            AudioToUIMsg out{AudioToUIMsg::SET_MACRO_NAME};
+            out.paramId = mi;
+            out.patchNamePointer = buf.data();
+            audioToUi.push(out);
+            rescan |= RescanRequest::INFO;
+        }
+    }
+
+    patch.dirty = false;
+    audioToUi.push({AudioToUIMsg::SET_PATCH_DIRTY_STATE, patch.dirty});
+    audioRunning = true;
+    monoValues.paramVersion++;
+    monoValues.paramSetVersion++;
+    postLoad();
+
+    // onMainThread frees it; the rescan this load asks for brings that call
+    if (!retiredPatchImages.push(img) && !unretiredPatchImage)
+        unretiredPatchImage = img;
+
+    // Every value just changed, so the host re-reads them all
+    return rescan | RescanRequest::VALUES;
+}
+
+void Synth::freeRetiredPatchImages()
+{
+    auto img = retiredPatchImages.pop();
+    while (img.has_value())
+    {
+        delete *img;
+        img = retiredPatchImages.pop();
+    }
+}
+
 void Synth::requestParamRescan(uint32_t flags)
 {
     if (flags == 0 || !clapHost)
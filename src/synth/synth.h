@@ -19,7 +19,10 @@
 #include <memory>
 #include <array>
 #include <cassert>
+#include <chrono>
+#include <cstring>
 #include <string>
+#include <vector>
 
 #include "sst/basic-blocks/dsp/LanczosResampler.h"
 #include "sst/filters/ButterworthLPHP.h"
@@ -37,8 +40,12 @@ class TiXmlElement;
 #include "filesystem/import.h"
 
 #include "configuration.h"
+#include "dsp/integer_decimator.h"
+#include "dsp/polyphase_decimator.h"
 
 #include "synth/voice.h"
+#include "synth/voice_render_pool.h"
+#include "synth/engine_stats.h"
 #include "synth/patch.h"
 #include "mono_values.h"
 #include "mod_matrix.h"
@@ -63,7 +70,22 @@ struct Synth
 
     using resampler_t = sst::basic_blocks::dsp::LanczosResampler<blockSize>;
     std::array<std::unique_ptr<resampler_t>, 1 + numOps> resampler;
-    std::array<SRC_STATE *, 1 + numOps> lState{}, rState{};
+
+    // LANCZOS at a ratio PolyphaseDecimator can tabulate (any 44.1 or 48k
+    // multiple) runs every bus through this in one pass instead of resampler[]
+    using decimator_t = PolyphaseDecimator<2 * (1 + numOps)>;
+    std::unique_ptr<decimator_t> decimator;
+    bool useDecimator{false};
+
+    // INT_DECIMATE when the engine rate is a whole multiple of the host rate;
+    // otherwise that engine runs as SRC_FAST
+    using intDecimator_t = IntegerDecimator<2 * (1 + numOps)>;
+    std::unique_ptr<intDecimator_t> intDecimator;
+    bool useIntDecimator{false};
+
+    // One interleaved state carries every channel of every bus through SRC
+    SRC_STATE *srcState{nullptr};
+    int srcChannels{0};
 
     // Audio input upsampling: host rate -> engine rate
     using audioInResampler_t = sst::basic_blocks::dsp::LanczosResampler<blockSize>;
@@ -91,6 +113,46 @@ struct Synth
     void dumpVoiceList();
     int voiceCount{0};
 
+    // When set, voices on the list render in packs of SinTable::lanes so each
+    // operator's table lookup runs across voices in one SIMD op. Off renders
+    // each voice on its own; the output is identical either way.
+    bool packVoicesForRender{true};
+    void renderVoicePack(Voice *const *pack, int n);
+
+    // Optional worker pool for voice rendering. Voices render into their own
+    // output, and the sum into the bus stays serial and in list order, so the
+    // result matches the single threaded render exactly. Below the voice
+    // threshold a block isn't worth the handoff and renders on the audio thread.
+    VoiceRenderPool renderPool;
+    int renderThreadsVoiceThreshold{16};
+    std::atomic<int> requestedRenderThreads{1};
+    void setRenderThreads(int n); // main thread
+    std::array<Voice *, VMConfig::maxVoiceCount> renderList{};
+    int renderListCount{0};
+
+    /*
+     * CPU budget, as a fraction of one core's realtime (0.75 is 75%); 0 is off.
+     * endHostBlock times every host block for the engine stats and hands the load to
+     * applyCpuBudget, which smooths it over budgetWindowSeconds of audio. Only when
+     * the smoothed load has stayed over budget for a whole window does it shed, and
+     * then at most one voice in budgetMaxShedDivisor of those sounding, releasing
+     * voices (quietest first) while there are any. Held notes only go once no
+     * releasing voices are left and the load is still over. After each decision
+     * it waits another window for the load to settle. Each shed voice goes with
+     * the short fade the voice manager uses to steal, and the voice manager hears
+     * it end as usual.
+     */
+    static constexpr double budgetWindowSeconds{0.2};
+    static constexpr int budgetMaxShedDivisor{8};
+    std::atomic<float> cpuBudget{0.f};
+    void setCpuBudget(float b) { cpuBudget = std::max(b, 0.f); } // main thread
+    std::atomic<uint32_t> voicesShed{0};                           // since construction
+    double budgetLoad{0};
+    double budgetOverFrames{0}, budgetHoldoffFrames{0};
+    void applyCpuBudget(double load, uint32_t frames, float budget);
+    int shedVoices(int n);
+    static void renderListItem(void *synth, int item);
+
     struct PortaContinuation
     {
         bool active{false};
@@ -295,9 +357,119 @@ struct Synth
 
     template <bool multiOut> void processInternal(const clap_output_events_t *);
 
+    // Produce one blockSize run of host-rate output into output[][]. This does
+    // the once-per-host-call work (UI queue drain, cpu timing) around a single
+    // engine block; processBlock below is the host-buffer sized version.
     void process(const clap_output_events_t *);
     void processUIQueue(const clap_output_events_t *);
 
+    void beginHostBlock(const clap_output_events_t *);
+    void processEngineBlock(const clap_output_events_t *);
+    void endHostBlock(uint32_t frames);
+    std::chrono::high_resolution_clock::time_point hostBlockStart;
+
+    // Position inside output[][] for the host buffer, which carries across
+    // host calls since their sizes needn't be a multiple of blockSize.
+    uint32_t hostBlockPos{0};
+
+    // Engine samples rendered past the next host sample, which is what the
+    // resampler holds on top of its own fixed latency, and the least of that seen
+    // since the resamplers were built. Their difference is how far the engine
+    // already runs ahead of the host position, from zero up to a block.
+    double engineLead{0}, engineLeadFloor{0};
+    bool engineLeadKnown{false};
+
+    /*
+     * Start delay lines for sample accurate timing, one Voice::StartDelayLines per
+     * voice and indexed alike. At about 4k a voice they are only allocated once a
+     * patch uses that timing: prepareStartDelayLines does it on the main thread and
+     * publishes the pool, and startDelayLinesReady hands it to the voices the first
+     * time the audio thread sees it. Until then the audio thread asks the host for
+     * a main thread callback to allocate them and runs block timing.
+     */
+    std::unique_ptr<Voice::StartDelayLines[]> startDelayStorage;
+    std::atomic<Voice::StartDelayLines *> startDelayPool{nullptr};
+    std::atomic<bool> startDelayLinesRequested{false};
+    bool startDelayLinesWired{false};
+    void prepareStartDelayLines();
+    bool startDelayLinesReady();
+
+    /*
+     * Render a whole host buffer of `frames` samples into outs (two channels per
+     * output bus) with the once-per-call work done once, rather than per engine
+     * block. Events are still applied on engine block boundaries:
+     * dispatchEvents(s) must apply every pending event with time <= s and return
+     * the time of the next one (or uint32 max), and it is only called again once
+     * the render reaches that frame. Runs between events copy into host memory a
+     * block at a time. Audio in may be null.
+     *
+     * With the patch in ET_SAMPLE_ACCURATE timing, events inside the upcoming
+     * engine block are instead dispatched at its start, one timestamp at a time,
+     * with MonoValues::voiceStartDelay set so the voices it starts are held back to
+     * the exact sample. That delay is the event's offset into the host block plus
+     * a fixed engine block, less whatever the resampler already holds past the
+     * host position, so every onset lands the same latency after its event however
+     * many engine blocks this host block renders. Non-note events in that mode
+     * land up to a block early rather than up to a block late. Until the start
+     * delay lines are allocated that mode runs as block timing.
+     */
+    template <typename EventFn>
+    void processBlock(uint32_t frames, float *const *outs, const float *inL, const float *inR,
+                      const clap_output_events_t *outq, EventFn &&dispatchEvents)
+    {
+        beginHostBlock(outq);
+
+        const bool sampleAccurate =
+            (int)std::round(patch.output.eventTiming.value) == ET_SAMPLE_ACCURATE &&
+            startDelayLinesReady();
+        const int nChan = isMultiOut ? 2 * (1 + numOps) : 2;
+        uint32_t nextEvent{0};
+        uint32_t s{0};
+        while (s < frames)
+        {
+            auto pushFrom = s;
+            if (hostBlockPos == 0)
+            {
+                pushAudioIn(inL ? inL[s] : 0.f, inR ? inR[s] : 0.f);
+                pushFrom++;
+
+                if (sampleAccurate)
+                {
+                    auto ahead = engineLeadKnown ? engineLead - engineLeadFloor : 0.0;
+                    auto blockEnd = std::min(s + (uint32_t)blockSize, frames);
+                    while (nextEvent < blockEnd)
+                    {
+                        auto at = std::max(nextEvent, s);
+                        monoValues.voiceStartDelay =
+                            (int32_t)std::round(blockSize - ahead + (at - s) / sampleRateRatio);
+                        nextEvent = dispatchEvents(at);
+                    }
+                    monoValues.voiceStartDelay = 0;
+                }
+                else if (s >= nextEvent)
+                {
+                    nextEvent = dispatchEvents(s);
+                }
+
+                processEngineBlock(outq);
+            }
+
+            auto n = std::min((uint32_t)blockSize - hostBlockPos, frames - s);
+            if (audioInResampler)
+            {
+                for (auto i = pushFrom; i < s + n; ++i)
+                    audioInResampler->push(inL ? inL[i] : 0.f, inR ? inR[i] : 0.f);
+            }
+            for (int c = 0; c < nChan; ++c)
+                memcpy(outs[c] + s, output[c] + hostBlockPos, n * sizeof(float));
+
+            hostBlockPos = (hostBlockPos + n) % blockSize;
+            s += n;
+        }
+
+        endHostBlock(frames);
+    }
+
     // End-of-chain processing on the engine-rate stereo bus, in place.
     // Runs the saturator / lowpass / decimator / bitcrush / highpass stages.
     void processEndOfBlock(float *L, float *R);
@@ -403,7 +575,7 @@ struct Synth
         {
             UPDATE_PARAM,
             UPDATE_VU,
-            UPDATE_VOICE_COUNT,
+            UPDATE_VOICE_COUNT, // value is the running count of voices shed for cpu
             UPDATE_CPU_USAGE,
             SET_PATCH_NAME,
             SET_PATCH_DIRTY_STATE,
@@ -438,7 +610,10 @@ struct Synth
             PANIC_STOP_VOICES,
             SET_DESIGN_MODE_RUN_ALL,
             SET_DAW_EXTRA_STATE,
-            SEND_MACRO_NAME // paramId = macro index, uiManagedPointer = name buffer
+            SEND_MACRO_NAME, // paramId = macro index, uiManagedPointer = name buffer
+            SET_RENDER_THREADS,
+            SET_CPU_BUDGET, // value is the fraction of a core, 0 for off
+            INSTALL_PATCH_IMAGE // dawExtraStatePointer = PatchImage*, owned by us from here
         } action;
         uint32_t paramId{0};
         float value{0};
@@ -471,32 +646,53 @@ struct Synth
     bool isEditorAttached{false};
     sst::basic_blocks::dsp::UIComponentLagHandler lagHandler;
 
-    std::atomic<bool> readyForStream{false};
+    // The UI lag runs one param at a time; this is it and where it is heading
+    Param *uiLagParam{nullptr};
+    float uiLagTarget{0.f};
+
     void prepForStream()
     {
-        if (lagHandler.active)
-            lagHandler.instantlySnap();
-
-        for (auto &p : paramLagSet)
-        {
-            p.lag.snapToTarget();
-            p.value = p.lag.v;
-        }
-        paramLagSet.removeAll();
-
         patch.dirty = false;
-        doFullRefresh = true;
-        readyForStream = true;
+        audioToUi.push({AudioToUIMsg::SET_PATCH_DIRTY_STATE, patch.dirty});
     }
 
+    /*
+     * What stateSave writes, published by the audio thread so the main thread never
+     * waits on it or reads the live patch. After any param or patch string change
+     * processInternal copies the param values, taking a lagging param at its lag
+     * target as the saved value always has, plus the patch strings into the back
+     * one of two buffers. Each buffer carries a sequence count which is odd while
+     * it is written (a seqlock); a reader copies the published buffer and retries
+     * if the count moved under it, which needs the audio thread to lap it.
+     */
+    struct StreamBuffer
+    {
+        std::atomic<uint32_t> seq{0};
+        std::vector<float> values;
+        char name[stringBufferLen]{};
+        char author[stringBufferLen]{};
+        std::array<std::array<char, 64>, numMacros> macroNames{};
+    };
+    std::array<StreamBuffer, 2> streamBuffers;
+    std::atomic<int> streamPublished{-1};
+    bool streamSnapshotDirty{true};
+    void publishStreamSnapshot();
+
+    // Main thread. The patch to serialise for a state save: a copy of the latest
+    // snapshot, or the live patch if the audio thread has never published one (it
+    // has never run, so there is nobody to race).
+    std::unique_ptr<Patch> streamPatch;
+    Patch &patchForStream();
+
     void pushFullUIRefresh();
     void postLoad()
     {
         doFullRefresh = true;
+        streamSnapshotDirty = true;
         reapplyControlSettings();
         resetSoloState();
 
-        for (auto &[i, p] : patch.paramMap)
+        for (auto *p : patch.params)
         {
             p->lag.snapTo(p->value);
         }
@@ -505,6 +701,19 @@ struct Synth
     std::atomic<uint32_t> onMainRescanFlags{0};
     void onMainThread();
 
+    /*
+     * Audio thread. Takes a whole preset at once: voices stop, every value is
+     * copied in by index and snapped, then the side effects run once in postLoad.
+     * The image is then queued back for onMainThread to free, so the audio thread
+     * never deallocates. Should that queue fill (the main thread stalled over 64
+     * loads) one image is parked for the destructor and any more leak, rather than
+     * be freed here. Returns the rescans the load needs.
+     */
+    uint32_t installPatchImage(PatchImage *img);
+    sst::cpputils::SimpleRingBuffer<PatchImage *, 64> retiredPatchImages;
+    PatchImage *unretiredPatchImage{nullptr};
+    void freeRetiredPatchImages();
+
     void reapplyControlSettings();
     void resetSoloState();
     void handleAudioThreadParamSideEffects(Param *dest);
@@ -514,6 +723,7 @@ struct Synth
     sst::basic_blocks::dsp::VUPeak vuPeak;
     std::array<sst::basic_blocks::dsp::VUPeak, numOps> opVuPeak;
     double cpuUsage{0};
+    EngineStats stats; // always on; read from any thread
     int32_t updateVuEvery{(int32_t)(48000 * 2.5 / 60 / blockSize)}; // approx
     int32_t lastVuUpdate{updateVuEvery};
 
@@ -46,8 +46,33 @@ Voice::Voice(const Patch &p, MonoValues &mv)
 {
     std::fill(isKeytrack.begin(), isKeytrack.end(), true);
     std::fill(cmRatio.begin(), cmRatio.end(), 1.f);
+    std::fill(opLive.begin(), opLive.end(), true);
     for (int i = 0; i < numOps; ++i)
         src[i].opIndex = i;
+
+    stepStates = std::make_unique<StepStates>(mv);
+    auto *slot = stepStates->states.data();
+    auto wire = [&slot](auto &node) { node.step = slot++; };
+    for (auto &n : src)
+        wire(n);
+    for (auto &n : selfNode)
+        wire(n);
+    for (auto &n : matrixNode)
+        wire(n);
+    for (auto &n : mixerNode)
+        wire(n);
+    for (auto &n : macroNode)
+        wire(n);
+    wire(out);
+    wire(out.panModNode);
+    wire(out.ftModNode);
+    assert(slot == stepStates->states.data() + numLfoNodes);
+}
+
+Voice::StepStates::StepStates(MonoValues &mv)
+    : states(scpu::make_array_lambda<StepLFOState, numLfoNodes>(
+          [&mv](auto) { return StepLFOState(mv); }))
+{
 }
 
 void Voice::attack()
@@ -67,11 +92,63 @@ void Voice::attack()
     for (auto &n : matrixNode)
         n.attack();
 
+    rebuildRouting();
+
+    startDelay = startDelayLines ? std::clamp(monoValues.voiceStartDelay, 0, maxStartDelay) : 0;
+    startDelayPos = 0;
+    opStartDelayBlocks.fill(0);
+    if (startDelay > 0)
+        memset(startDelayLines, 0, sizeof(*startDelayLines));
+
     voiceValues.setGated(true);
 }
 
 void Voice::renderBlock()
 {
+    beginBlock();
+
+    for (int i = 0; i < numOps; ++i)
+    {
+        if (!prepareOp(i))
+            continue;
+        src[i].renderBlock();
+        mixerNode[i].renderBlock();
+    }
+
+    endBlock();
+}
+
+void Voice::rebuildRouting()
+{
+    routingVersion = monoValues.paramVersion;
+    auto runAll = monoValues.designModeRunAll;
+
+    // Edges only run from lower to higher ops, so walking down sees every target
+    // before its sources.
+    for (int i = numOps - 1; i >= 0; --i)
+    {
+        auto &mx = mixerNode[i];
+        auto mixLive = runAll || mx.reachesOutput();
+        if (mx.live && !mixLive)
+            memset(mx.output, 0, sizeof(mx.output));
+        mx.live = mixLive;
+
+        auto live = mixLive;
+        for (int k = i + 1; k < numOps; ++k)
+        {
+            auto &e = matrixNode[MatrixIndex::positionForSourceTarget(i, k)];
+            e.live = opLive[k] && (runAll || e.contributes());
+            live = live || e.live;
+        }
+        opLive[i] = src[i].active && live;
+    }
+}
+
+void Voice::beginBlock()
+{
+    if (routingVersion != monoValues.paramVersion)
+        rebuildRouting();
+
     // Refresh unison-derived per-voice scalars from the (smoothed) mono hoists so
     // unisonSpread / unisonPan track host automation and UI knob moves mid-note.
     if (voiceValues.uniCount > 1)
@@ -129,10 +206,10 @@ void Voice::renderBlock()
         voiceValues.portaFrac = 0;
     }
 
-    auto octSh = std::clamp((int)std::round(out.octTranspose), -3, 3);
-    static constexpr float octFac[7] = {1.0 / 8.0, 1.0 / 4.0, 1.0 / 2.0, 1.0, 2.0, 4.0, 8.0};
-
-    auto baseFreq = monoValues.tuningProvider.note_to_pitch(retuneKey - 69) * 440.0;
+    blockOctShift = std::clamp((int)std::round(out.octTranspose), -3, 3);
+    blockAdaptiveRate =
+        (int)std::round(out.outputNode.opRenderRate.value) == OpRenderRate::ORR_ADAPTIVE;
+    blockBaseFreq = monoValues.tuningProvider.note_to_pitch(retuneKey - 69) * 440.0;
 
     voiceValues.velocityLag.setTarget(voiceValues.velocity);
     voiceValues.velocityLag.process();
@@ -157,29 +234,58 @@ void Voice::renderBlock()
         }
         mn.wasPowerOn = mn.macroPowerOn;
     }
+}
 
-    for (int i = 0; i < numOps; ++i)
+bool Voice::prepareOp(int i)
+{
+    static constexpr float octFac[7] = {1.0 / 8.0, 1.0 / 4.0, 1.0 / 2.0, 1.0, 2.0, 4.0, 8.0};
+
+    if (!src[i].active)
     {
-        if (!src[i].active)
-        {
-            src[i].clearOutputs();
-            continue;
-        }
-        src[i].zeroInputs();
-        auto octPer = std::clamp((int)std::round(src[i].octTranspose), -3, 3);
+        src[i].clearOutputs();
+        return false;
+    }
+    src[i].zeroInputs();
+    auto octPer = std::clamp((int)std::round(src[i].octTranspose), -3, 3);
+
+    src[i].setBaseFrequency(blockBaseFreq, octFac[blockOctShift + 3] * octFac[octPer + 3]);
 
-        src[i].setBaseFrequency(baseFreq, octFac[octSh + 3] * octFac[octPer + 3]);
+    if (!opLive[i])
+    {
+        // Every edge into a dead op is dead too, so these only keep time
         for (auto j = 0; j < i; ++j)
-        {
-            auto pos = MatrixIndex::positionForSourceTarget(j, i);
-            matrixNode[pos].applyBlock();
-        }
+            matrixNode[MatrixIndex::positionForSourceTarget(j, i)].applyBlock();
         if (!src[i].isAudioInCachedAtAttack)
             selfNode[i].applyBlock();
-        src[i].renderBlock();
-        mixerNode[i].renderBlock();
+        src[i].advanceBlock();
+        return false;
+    }
+    // The phase (or frequency) input and the ring mod level are each a sum of
+    // sources, so each is as wide as its widest source, and the ring mod widens
+    // the op's own output by its level's width.
+    float phaseBandwidth{0.f}, rmBandwidth{0.f};
+    for (auto j = 0; j < i; ++j)
+    {
+        auto pos = MatrixIndex::positionForSourceTarget(j, i);
+        auto &mn = matrixNode[pos];
+        mn.applyBlock();
+        if (!blockAdaptiveRate || !mn.active || !mn.live)
+            continue;
+        if (mn.modMode == 1)
+            // Ring mod by |source| folds the source up into all its even harmonics
+            rmBandwidth = std::max(rmBandwidth, mn.rmScale == 1 ? 0.5f : src[j].bandwidth);
+        else
+            phaseBandwidth = std::max(phaseBandwidth, src[j].bandwidth);
     }
+    src[i].adaptiveRate = blockAdaptiveRate;
+    src[i].modBandwidth = phaseBandwidth + rmBandwidth;
+    if (!src[i].isAudioInCachedAtAttack)
+        selfNode[i].applyBlock();
+    return true;
+}
 
+void Voice::endBlock()
+{
     out.renderBlock();
 
     if (fadeBlocks > 0)
@@ -194,6 +300,58 @@ void Voice::renderBlock()
         }
         fadeBlocks--;
     }
+
+    if (startDelay > 0)
+        applyStartDelay();
+}
+
+void Voice::applyStartDelay()
+{
+    auto delay = [this](float (&io)[2][blockSize], float (&line)[2][maxStartDelay])
+    {
+        auto pos = startDelayPos;
+        for (int i = 0; i < blockSize; ++i)
+        {
+            for (int c = 0; c < 2; ++c)
+            {
+                auto v = io[c][i];
+                io[c][i] = line[c][pos];
+                line[c][pos] = v;
+            }
+            pos++;
+            if (pos == startDelay)
+                pos = 0;
+        }
+    };
+
+    auto &lines = *startDelayLines;
+    delay(out.output, lines.main);
+
+    // An op bus written this block holds its line for as many blocks as the delay
+    // spans. One which wasn't feeds its line silence until the tail is out, and
+    // stays in the mask meanwhile so the synth still sums it.
+    const auto tailBlocks = (int32_t)((startDelay + blockSize - 1) / blockSize);
+    for (int i = 0; i < numOps; ++i)
+    {
+        auto bit = 1u << i;
+        if (out.opOutputMask & bit)
+        {
+            opStartDelayBlocks[i] = tailBlocks;
+        }
+        else if (opStartDelayBlocks[i] > 0)
+        {
+            memset(out.opOutput[i], 0, sizeof(out.opOutput[i]));
+            opStartDelayBlocks[i]--;
+            out.opOutputMask |= bit;
+        }
+        else
+        {
+            continue;
+        }
+        delay(out.opOutput[i], lines.op[i]);
+    }
+
+    startDelayPos = (startDelayPos + blockSize) % startDelay;
 }
 
 static_assert(numOps == 6, "Rebuild this table if not");
@@ -306,6 +464,8 @@ void Voice::cleanup()
 {
     used = false;
     fadeBlocks = -1;
+    shedForCpu = false;
+    startDelay = 0;
     voiceValues.setGated(false);
     voiceValues.portaDiff = 0;
     voiceValues.portaFrac = 0;
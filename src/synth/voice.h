@@ -16,6 +16,7 @@
 #ifndef BACONPAUL_SIX_SINES_SYNTH_VOICE_H
 #define BACONPAUL_SIX_SINES_SYNTH_VOICE_H
 
+#include <memory>
 #include <sst/basic-blocks/tables/EqualTuningProvider.h>
 #include "dsp/op_source.h"
 #include "dsp/matrix_node.h"
@@ -42,6 +43,30 @@ struct Voice
     void renderBlock();
     void cleanup();
 
+    /*
+     * renderBlock in pieces, so the synth can interleave the operators of several
+     * voices and render them as a pack. beginBlock does the per-voice pitch and macro
+     * work, prepareOp routes the matrix into op i (returning false if there is nothing
+     * to render, having advanced a dead op itself), and endBlock runs the output node
+     * and fade.
+     */
+    void beginBlock();
+    bool prepareOp(int i);
+    void endBlock();
+
+    /*
+     * Which ops and matrix edges can reach the output. An op is live if its mixer
+     * can be heard or a live edge carries it to a live op; an edge is live if it
+     * contributes anything and its target is live. Dead ops skip their table
+     * lookups and dead mixers and edges skip their audio, but all of them still run
+     * their envelopes, LFOs and (for ops) phase, since the levels which made them
+     * dead can be modulated or automated back up mid-note. Rebuilt at attack and
+     * whenever monoValues.paramVersion moves.
+     */
+    std::array<bool, numOps> opLive;
+    uint32_t routingVersion{0};
+    void rebuildRouting();
+
     bool used{false};
 
     std::array<OpSource, numOps> src;
@@ -62,12 +87,48 @@ struct Voice
 
     std::array<MixerNode, numOps> mixerNode;
     std::array<MacroVoiceNode, numMacros> macroNode;
-    static constexpr int32_t fadeOverBlocks{32};
+    // A fixed 256 engine samples whatever the block size
+    static constexpr int32_t fadeOverBlocks{256 / blockSize};
     float dFade{1.0 / (blockSize * fadeOverBlocks)};
     int32_t fadeBlocks{-1};
+    bool shedForCpu{false}; // fading because Synth::shedVoices chose it
+
+    // Sub-block start offset for sample accurate event timing; see
+    // MonoValues::voiceStartDelay. Long enough for a host block at 8x oversample
+    // plus the engine block of latency Synth::processBlock adds.
+    // The per op buses (OutputNode::opOutput) are delayed alongside the main output,
+    // each in its own line; opStartDelayBlocks[i] counts the blocks op i's line still
+    // has to play out after the op stops writing its bus. The lines live in a pool
+    // the synth allocates only once sample accurate timing is used; until then this
+    // is null and startDelay stays zero. See Synth::prepareStartDelayLines.
+    static constexpr int32_t maxStartDelay{9 * blockSize};
+    struct StartDelayLines
+    {
+        float main[2][maxStartDelay];
+        float op[numOps][2][maxStartDelay];
+    };
+    StartDelayLines *startDelayLines{nullptr};
+    int32_t startDelay{0}, startDelayPos{0};
+    std::array<int32_t, numOps> opStartDelayBlocks{};
+    void applyStartDelay();
 
     OutputNode out;
 
+    // The step LFO state of every node above in one block; see StepLFOState. The
+    // constructor points each node's LFOSupport::step at its slot.
+    static constexpr size_t numLfoNodes{3 * numOps + matrixSize + numMacros + 3};
+    struct StepStates
+    {
+        explicit StepStates(MonoValues &mv);
+        std::array<StepLFOState, numLfoNodes> states;
+    };
+    std::unique_ptr<StepStates> stepStates;
+
+    // Latched by beginBlock for the prepareOp calls which follow
+    float blockBaseFreq{0.f};
+    int blockOctShift{0};
+    bool blockAdaptiveRate{false};
+
     Voice *prior{nullptr}, *next{nullptr};
 };
 } // namespace baconpaul::six_sines
@@ -0,0 +1,172 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#include "voice_render_pool.h"
+
+#include <algorithm>
+#include <cassert>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <sst/basic-blocks/simd/setup.h>
+
+namespace baconpaul::six_sines
+{
+namespace
+{
+// Engine blocks arrive back to back inside a host callback, so a worker spins for
+// about the gap between two of them before it parks until the next run().
+constexpr int spinsBeforePark{512};
+} // namespace
+
+void VoiceRenderPool::raiseWorkerPriority()
+{
+#if defined(_WIN32)
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+#elif defined(__APPLE__)
+    pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0);
+#else
+    // Below the usual host audio priorities, above everything else. Without an
+    // rtprio allowance this fails and the worker stays where it is.
+    sched_param sp{};
+    sp.sched_priority = std::max(sched_get_priority_min(SCHED_FIFO),
+                                 sched_get_priority_max(SCHED_FIFO) / 2);
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp);
+#endif
+}
+
+int VoiceRenderPool::maxUsefulThreads()
+{
+    // More threads than cores would leave a worker holding an item with no core to
+    // run on while the audio thread waits for it
+    static const int res =
+        std::clamp((int)std::thread::hardware_concurrency(), 1, (int)maxThreads);
+    return res;
+}
+
+void VoiceRenderPool::setThreadCount(int n)
+{
+    auto want = std::clamp(n, 1, maxUsefulThreads()) - 1;
+    auto have = nWorkers.load(std::memory_order_relaxed);
+
+    while (have > want)
+    {
+        --have;
+        nWorkers.store(have, std::memory_order_relaxed);
+        keepRunning[have].store(false, std::memory_order_seq_cst);
+        parking[have].wake.release();
+        if (workers[have].joinable())
+            workers[have].join();
+    }
+    while (have < want)
+    {
+        keepRunning[have].store(true, std::memory_order_release);
+        workers[have] = std::thread(&VoiceRenderPool::workerMain, this, have);
+        ++have;
+        nWorkers.store(have, std::memory_order_relaxed);
+    }
+}
+
+bool VoiceRenderPool::claimAndRun(uint64_t s)
+{
+    while (nextOf(s) < countOf(s))
+    {
+        // Success acquires the publish in run(), so job and jobCtx are current
+        if (state.compare_exchange_weak(s, s + 1, std::memory_order_acq_rel,
+                                        std::memory_order_acquire))
+        {
+            job(jobCtx, nextOf(s));
+            done.fetch_add(1, std::memory_order_release);
+            return true;
+        }
+    }
+    return false;
+}
+
+void VoiceRenderPool::run(job_t j, void *ctx, int count)
+{
+    assert(count >= 0 && (uint64_t)count <= fieldMask);
+    if (count <= 0)
+        return;
+
+    job = j;
+    jobCtx = ctx;
+    done.store(0, std::memory_order_relaxed);
+    ++generation;
+    state.store(((uint64_t)generation << 32) | ((uint64_t)count << 16),
+                std::memory_order_seq_cst);
+
+    // Pairs with the parked store then state recheck in workerMain, so either the
+    // worker sees this job or we see it parked
+    auto nw = nWorkers.load(std::memory_order_relaxed);
+    for (int i = 0; i < nw; ++i)
+    {
+        auto &pk = parking[i];
+        if (pk.parked.load(std::memory_order_seq_cst) &&
+            pk.parked.exchange(false, std::memory_order_acq_rel))
+            pk.wake.release();
+    }
+
+    while (claimAndRun(state.load(std::memory_order_acquire)))
+        ;
+
+    // Everything is claimed, each worker holding at most one item; wait out those
+    while (done.load(std::memory_order_acquire) < count)
+        _mm_pause();
+}
+
+void VoiceRenderPool::workerMain(int idx)
+{
+    raiseWorkerPriority();
+
+    int spins{0};
+    while (keepRunning[idx].load(std::memory_order_acquire))
+    {
+        if (claimAndRun(state.load(std::memory_order_acquire)))
+        {
+            spins = 0;
+            continue;
+        }
+
+        if (spins < spinsBeforePark)
+        {
+            ++spins;
+            _mm_pause();
+            continue;
+        }
+
+        // If run() clears parked after we back out here, the post it leaves behind
+        // only costs one extra pass round this loop later
+        auto &pk = parking[idx];
+        pk.parked.store(true, std::memory_order_seq_cst);
+        auto s = state.load(std::memory_order_seq_cst);
+        if (nextOf(s) < countOf(s) || !keepRunning[idx].load(std::memory_order_seq_cst))
+        {
+            pk.parked.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        pk.wake.acquire();
+        spins = 0;
+    }
+}
+} // namespace baconpaul::six_sines
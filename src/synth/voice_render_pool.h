@@ -0,0 +1,97 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#ifndef BACONPAUL_SIX_SINES_SYNTH_VOICE_RENDER_POOL_H
+#define BACONPAUL_SIX_SINES_SYNTH_VOICE_RENDER_POOL_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <semaphore>
+#include <thread>
+
+namespace baconpaul::six_sines
+{
+/*
+ * A small pool of pre-spawned workers which help the audio thread through a list
+ * of independent items (voices or voice packs) each engine block.
+ *
+ * The audio thread posts a job with run() and then claims items itself alongside
+ * the workers, one at a time, so it never waits on a worker which is asleep or
+ * descheduled before claiming; at worst it renders the whole list on its own and
+ * only waits for the few items a worker is part way through. Handoff is a single
+ * 64 bit atomic holding generation, item count and next index, claimed by CAS.
+ * Nothing in run() allocates or locks.
+ *
+ * Workers ask the OS for realtime or near realtime priority, so one part way
+ * through an item isn't preempted by ordinary threads while the audio thread waits
+ * on it; if that is refused they carry on at normal priority. Between jobs they
+ * spin, with a pause, only across the short gap between engine blocks, then park
+ * on a semaphore which run() posts when it has work.
+ */
+struct VoiceRenderPool
+{
+    static constexpr int maxThreads{16};
+    using job_t = void (*)(void *ctx, int item);
+
+    VoiceRenderPool() = default;
+    ~VoiceRenderPool() { setThreadCount(1); }
+    VoiceRenderPool(const VoiceRenderPool &) = delete;
+    VoiceRenderPool &operator=(const VoiceRenderPool &) = delete;
+
+    // Main thread. Counts the audio thread, so 1 means no workers, and is capped at
+    // the core count. Safe to call while the audio thread is in run(); a stopping
+    // worker finishes its item first.
+    void setThreadCount(int n);
+    int threadCount() const { return nWorkers.load(std::memory_order_relaxed) + 1; }
+    static int maxUsefulThreads(); // maxThreads or the core count, whichever is lower
+
+    // Audio thread. Calls job(ctx, i) for every i in [0, count) and returns once they
+    // have all completed. count must be below 1 << 16.
+    void run(job_t job, void *ctx, int count);
+
+  private:
+    void workerMain(int idx);
+    bool claimAndRun(uint64_t s);
+    static void raiseWorkerPriority();
+
+    static constexpr uint64_t fieldMask{(1 << 16) - 1};
+    static uint32_t genOf(uint64_t s) { return (uint32_t)(s >> 32); }
+    static int countOf(uint64_t s) { return (int)((s >> 16) & fieldMask); }
+    static int nextOf(uint64_t s) { return (int)(s & fieldMask); }
+
+    // Written by the audio thread before the state publish, read after a claim
+    job_t job{nullptr};
+    void *jobCtx{nullptr};
+
+    alignas(64) std::atomic<uint64_t> state{0};
+    alignas(64) std::atomic<int> done{0};
+    uint32_t generation{0};
+
+
+    std::atomic<int> nWorkers{0};
+    std::array<std::thread, maxThreads - 1> workers;
+    std::array<std::atomic<bool>, maxThreads - 1> keepRunning{};
+
+    // Each worker parks on its own semaphore, which run() posts if parked is set
+    struct alignas(64) Parking
+    {
+        std::atomic<bool> parked{false};
+        std::counting_semaphore<> wake{0};
+    };
+    std::array<Parking, maxThreads - 1> parking;
+};
+} // namespace baconpaul::six_sines
+#endif // BACONPAUL_SIX_SINES_SYNTH_VOICE_RENDER_POOL_H
@@ -20,6 +20,7 @@
 #include <sst/basic-blocks/tables/EqualTuningProvider.h>
 #include <sst/basic-blocks/tables/TwoToTheXProvider.h>
 #include "sst/basic-blocks/dsp/Lag.h"
+#include "sst/basic-blocks/dsp/RNG.h"
 #include "configuration.h"
 
 struct MTSClient;
@@ -69,6 +70,11 @@ struct VoiceValues
 
     std::array<float, numMacros> macroOut{};
 
+    // Render-time random draws (noise ops, random and step LFOs) come from here rather
+    // than MonoValues::rng so voices never share generator state while rendering. The
+    // nodes hold a const VoiceValues, hence mutable. Attack-time draws stay on the mono rng.
+    mutable sst::basic_blocks::dsp::RNG rng;
+
   private:
     bool gatedV{false};
     int keyV{0};
@@ -15,6 +15,7 @@
 
 #include "playmode-sub-panel.h"
 #include <sst/jucegui/layouts/ListLayout.h>
+#include <fmt/core.h>
 #include "libMTSClient.h"
 
 namespace baconpaul::six_sines::ui
@@ -159,6 +160,13 @@ PlayModeSubPanel::PlayModeSubPanel(SixSinesEditor &e) : HasEditor(e)
     createComponent(editor, *this, on.octTranspose, tsposeButton, tsposeButtonD);
     addAndMakeVisible(*tsposeButton);
 
+    timingTitle = std::make_unique<jcmp::RuledLabel>();
+    timingTitle->setText("Event Timing");
+    addAndMakeVisible(*timingTitle);
+
+    createComponent(editor, *this, on.eventTiming, timingButton, timingButtonD);
+    addAndMakeVisible(*timingButton);
+
     voiceLimitL = std::make_unique<jcmp::RuledLabel>();
     voiceLimitL->setText("Voices");
     addAndMakeVisible(*voiceLimitL);
@@ -185,6 +193,13 @@ PlayModeSubPanel::PlayModeSubPanel(SixSinesEditor &e) : HasEditor(e)
     mtsStatusLabel->setEnabled(false);
     addAndMakeVisible(*mtsStatusLabel);
 
+    presetCacheTitle = std::make_unique<jcmp::RuledLabel>();
+    presetCacheTitle->setText("Preset Prefetch");
+    addAndMakeVisible(*presetCacheTitle);
+    presetCacheLabel = std::make_unique<jcmp::Label>();
+    presetCacheLabel->setText("No presets loaded yet");
+    addAndMakeVisible(*presetCacheLabel);
+
     panicTitle = std::make_unique<jcmp::RuledLabel>();
     panicTitle->setText("Panic");
     panicButton = std::make_unique<jcmp::TextPushButton>();
@@ -203,6 +218,8 @@ PlayModeSubPanel::PlayModeSubPanel(SixSinesEditor &e) : HasEditor(e)
     addAndMakeVisible(*srStrat);
     createComponent(editor, *this, out.resampleEngine, rsEng, rsEngD);
     addAndMakeVisible(*rsEng);
+    createComponent(editor, *this, out.opRenderRate, opRate, opRateD);
+    addAndMakeVisible(*opRate);
 
     createComponent(editor, *this, out.saturationType, satType, satTypeD);
     addAndMakeVisible(*satType);
@@ -228,6 +245,7 @@ PlayModeSubPanel::PlayModeSubPanel(SixSinesEditor &e) : HasEditor(e)
         addAndMakeVisible(*slot);
     };
     mkLabel(sampleRateLabel, "Sample Rate:");
+    mkLabel(opRateLabel, "Operator Rate:");
     mkLabel(saturationLabel, "Saturation:");
     mkLabel(lowpassLabel, "Low Pass:");
     mkLabel(bitRateLabel, "Bit Rate:");
@@ -283,6 +301,8 @@ void PlayModeSubPanel::resized()
     col3.add(sideLabel(bDnL, bDn));
     col3.add(titleLabelGaplessLayout(tsposeTitle));
     col3.add(jlo::Component(*tsposeButton).withHeight(uicLabelHeight));
+    col3.add(titleLabelGaplessLayout(timingTitle));
+    col3.add(jlo::Component(*timingButton).withHeight(uicLabelHeight));
     topRow.add(col3);
 
     auto col4 = jlo::VList().withWidth(skinny).withAutoGap(uicMargin);
@@ -326,6 +346,7 @@ void PlayModeSubPanel::resized()
     };
 
     pathCol.add(stageRow(sampleRateLabel, srStrat));
+    pathCol.add(stageRow(opRateLabel, opRate));
     pathCol.add(stageRow(saturationLabel, satType, satDrive.get()));
     pathCol.add(stageRow(bitRateLabel, bitRate));
     pathCol.add(stageRow(bitDepthLabel, bitDepth));
@@ -336,6 +357,9 @@ void PlayModeSubPanel::resized()
 
     outer.add(pathCol);
 
+    outer.add(titleLabelGaplessLayout(presetCacheTitle).withWidth(fullWidth));
+    outer.add(jlo::Component(*presetCacheLabel).withWidth(fullWidth).withHeight(uicLabelHeight));
+
     outer.doLayout();
 }
 
@@ -533,4 +557,24 @@ void PlayModeSubPanel::updateMTSStatus()
     }
 }
 
+void PlayModeSubPanel::updatePresetCacheStatus()
+{
+    if (++presetCacheIdleCount < 50 || !editor.presetManager)
+        return;
+    presetCacheIdleCount = 0;
+
+    const auto &st = editor.presetManager->prefetchStats;
+    auto loads = st.hits + st.misses;
+    if (loads == 0)
+        return;
+
+    auto text = fmt::format("{} of {} loads prefetched ({}%). Load time {:.2f} ms prefetched, "
+                            "{:.2f} ms from file",
+                            st.hits, loads, (int)std::round(100.0 * st.hits / loads),
+                            st.hits ? st.hitMs / st.hits : 0.0,
+                            st.misses ? st.missMs / st.misses : 0.0);
+    if (text != presetCacheLabel->getText())
+        presetCacheLabel->setText(text);
+}
+
 } // namespace baconpaul::six_sines::ui
@@ -44,6 +44,11 @@ struct PlayModeSubPanel : juce::Component, HasEditor
     bool mtsConnected{false};
     void updateMTSStatus();
 
+    std::unique_ptr<jcmp::RuledLabel> presetCacheTitle;
+    std::unique_ptr<jcmp::Label> presetCacheLabel;
+    int presetCacheIdleCount{0};
+    void updatePresetCacheStatus();
+
     std::unique_ptr<jcmp::Label> bUpL, bDnL;
     std::unique_ptr<PatchContinuous> bUpD, bDnD;
     std::unique_ptr<jcmp::DraggableTextEditableValue> bUp, bDn;
@@ -86,6 +91,10 @@ struct PlayModeSubPanel : juce::Component, HasEditor
     std::unique_ptr<jcmp::JogUpDownButton> tsposeButton;
     std::unique_ptr<PatchDiscrete> tsposeButtonD;
 
+    std::unique_ptr<jcmp::RuledLabel> timingTitle;
+    std::unique_ptr<jcmp::JogUpDownButton> timingButton;
+    std::unique_ptr<PatchDiscrete> timingButtonD;
+
     std::unique_ptr<jcmp::MenuButton> voiceLimit;
     std::unique_ptr<jcmp::RuledLabel> voiceLimitL;
 
@@ -97,6 +106,8 @@ struct PlayModeSubPanel : juce::Component, HasEditor
     std::unique_ptr<PatchDiscrete> srStratD;
     std::unique_ptr<jcmp::JogUpDownButton> rsEng;
     std::unique_ptr<PatchDiscrete> rsEngD;
+    std::unique_ptr<jcmp::JogUpDownButton> opRate;
+    std::unique_ptr<PatchDiscrete> opRateD;
 
     std::unique_ptr<jcmp::JogUpDownButton> satType, lowpass, bitRate, bitDepth, highpass;
     std::unique_ptr<PatchDiscrete> satTypeD, lowpassD, bitRateD, bitDepthD, highpassD;
@@ -108,7 +119,7 @@ struct PlayModeSubPanel : juce::Component, HasEditor
     std::unique_ptr<PatchContinuous> outGainD;
     std::unique_ptr<jcmp::Label> outGainLabel;
 
-    std::unique_ptr<jcmp::Label> sampleRateLabel, downsamplerLabel;
+    std::unique_ptr<jcmp::Label> sampleRateLabel, opRateLabel, downsamplerLabel;
     std::unique_ptr<jcmp::Label> saturationLabel, lowpassLabel, bitRateLabel, bitDepthLabel,
         highpassLabel;
 
@@ -34,7 +34,13 @@ struct SettingsPanel : jcmp::NamedPanel, HasEditor
     void beginEdit();
     void clearHighlight();
 
-    void setVoiceCount(int vc) { voiceCount->setText("Voices: " + std::to_string(vc)); }
+    void setVoiceCount(int vc, int shed = 0)
+    {
+        if (shed > 0)
+            voiceCount->setText(fmt::format("Voices: {} ({} shed)", vc, shed));
+        else
+            voiceCount->setText("Voices: " + std::to_string(vc));
+    }
     void setCpuUsage(double cpu)
     {
         if (std::round(cpu) != std::round(lastCpu))
@@ -15,6 +15,7 @@
 
 #include <cstring>
 #include <unordered_map>
+#include <thread>
 #include <cmrc/cmrc.hpp>
 #include "six-sines-editor.h"
 
@@ -123,6 +124,7 @@ SixSinesEditor::SixSinesEditor(Synth::audioToUIQueue_t &atou, Synth::mainToAudio
 
     // Some panels use defaults on construction
     presetManager = std::make_unique<presets::PresetManager>(clapHost);
+    presetManager->enablePrefetch();
     presetManager->onPresetLoaded = [this](auto s)
     {
         this->postPatchChange(s);
@@ -320,6 +322,7 @@ void SixSinesEditor::idle()
         SXSNLOG("Seems I have hit that renoise too-much-height bug");
         setZoomFactor(zoomFactor);
     }
+    presetManager->syncUserPresets();
     auto aum = audioToUI.pop();
     while (aum.has_value())
     {
@@ -341,7 +344,7 @@ void SixSinesEditor::idle()
         }
         else if (aum->action == Synth::AudioToUIMsg::UPDATE_VOICE_COUNT)
         {
-            settingsPanel->setVoiceCount(aum->paramId);
+            settingsPanel->setVoiceCount(aum->paramId, (int)aum->value);
             settingsPanel->repaint();
         }
         else if (aum->action == Synth::AudioToUIMsg::SET_PATCH_NAME)
@@ -405,7 +408,10 @@ void SixSinesEditor::idle()
     }
 
     if (playModeSubPanel)
+    {
         playModeSubPanel->updateMTSStatus();
+        playModeSubPanel->updatePresetCacheStatus();
+    }
 }
 
 void SixSinesEditor::paint(juce::Graphics &g)
@@ -900,6 +906,43 @@ void SixSinesEditor::showPresetPopup()
                });
     p.addSubMenu("Design Mode", dm);
 
+    auto rtm = juce::PopupMenu();
+    auto curThreads = defaultsProvider->getUserDefaultValue(Defaults::renderThreads, 1);
+    auto hwThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    for (int n = 1; n <= VoiceRenderPool::maxThreads; n *= 2)
+    {
+        if (n > 1 && n > hwThreads)
+            break;
+        rtm.addItem(n == 1 ? "Off (Audio Thread Only)" : (std::to_string(n) + " Threads"), true,
+                    n == curThreads,
+                    [w = juce::Component::SafePointer(this), n]()
+                    {
+                        if (!w)
+                            return;
+                        w->defaultsProvider->updateUserDefaultValue(Defaults::renderThreads, n);
+                        w->mainToAudio.push(
+                            {Synth::MainToAudioMsg::SET_RENDER_THREADS, 0, (float)n});
+                    });
+    }
+    p.addSubMenu("Voice Render Threads", rtm);
+
+    auto cbm = juce::PopupMenu();
+    auto curBudget = defaultsProvider->getUserDefaultValue(Defaults::cpuBudget, 0);
+    for (int pct : {0, 50, 75, 90, 100})
+    {
+        cbm.addItem(pct == 0 ? "Off" : (std::to_string(pct) + "% of a core"), true,
+                    pct == curBudget,
+                    [w = juce::Component::SafePointer(this), pct]()
+                    {
+                        if (!w)
+                            return;
+                        w->defaultsProvider->updateUserDefaultValue(Defaults::cpuBudget, pct);
+                        w->mainToAudio.push(
+                            {Synth::MainToAudioMsg::SET_CPU_BUDGET, 0, pct * 0.01f});
+                    });
+    }
+    p.addSubMenu("CPU Budget", cbm);
+
     p.addSeparator();
     p.addItem(spectrumWindow ? "Hide Analyzer" : "Show Analyzer",
               [w = juce::Component::SafePointer(this)]()
@@ -62,6 +62,7 @@ struct WavPainter : juce::Component
         g.setColour(gridCol);
         g.drawHorizontalLine(getHeight() / 2, 0, getWidth());
 
+        SinTable::prepareWaveForm(wfVal);
         st.setWaveForm(wfVal);
         uint32_t phase{0};
         phase += (1 << 26) * ph.value;
@@ -200,6 +201,7 @@ struct PDWavPainter : juce::Component
         g.drawHorizontalLine(waveBox.getY() + waveBox.getHeight() / 2, waveBox.getX(),
                              waveBox.getRight());
 
+        SinTable::prepareWaveForm(wfVal);
         st.setWaveForm(wfVal);
         uint32_t phs{0};
         phs += (1 << 26) * ph.value;
@@ -263,6 +265,8 @@ struct ResSweepPlotter : juce::Component
         return 4.0f;
     }
 
+    // The editor paints on the main thread, so it builds the tables it draws rather
+    // than letting setWaveForm fall back to SIN / HANN as the audio thread does
     void syncWindowTable()
     {
         using RW = Patch::SourceNode::ResonantSweepWindow;
@@ -270,12 +274,15 @@ struct ResSweepPlotter : juce::Component
         switch (rw)
         {
         case RW::BLACKMAN_HARRIS:
+            SinTable::prepareWaveForm(SinTable::BLACKMAN_HARRIS_WINDOW);
             stWindow.setWaveForm(SinTable::BLACKMAN_HARRIS_WINDOW);
             break;
         case RW::TUKEY:
+            SinTable::prepareWaveForm(SinTable::TUKEY_WINDOW);
             stWindow.setWaveForm(SinTable::TUKEY_WINDOW);
             break;
         default:
+            SinTable::prepareWaveForm(SinTable::HANN_WINDOW);
             stWindow.setWaveForm(SinTable::HANN_WINDOW);
             break;
         }
@@ -336,6 +343,7 @@ struct ResSweepPlotter : juce::Component
             g.drawVerticalLine(x, midY - halfTick, midY + halfTick);
         }
 
+        SinTable::prepareWaveForm(wfVal);
         st.setWaveForm(wfVal);
         syncWindowTable();
         using RW = Patch::SourceNode::ResonantSweepWindow;
@@ -470,6 +478,7 @@ struct NoisePainter : juce::Component
             g.drawVerticalLine(x, midY - halfTick, midY + halfTick);
         }
 
+        SinTable::prepareWaveForm(wfVal);
         st.setWaveForm(wfVal);
 
         using NM = Patch::SourceNode::NoiseMode;
@@ -1310,6 +1319,7 @@ void SourceSubPanel::showWaveformPopup()
                       {
                           if (!w)
                               return;
+                          SinTable::prepareWaveForm((SinTable::WaveForm)val);
                           w->editor.setAndSendParamValue(wfid, val);
                           w->wavButtonD->onGuiSetValue();
                       });
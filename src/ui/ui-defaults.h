@@ -34,6 +34,8 @@ enum Defaults
     spectrumAnalysisMode,
     spectrumScopeScale,
     sourceEditorType,
+    renderThreads,
+    cpuBudget, // percent of one core, 0 for off
     numDefaults
 };
 
@@ -67,6 +69,10 @@ inline std::string defaultName(Defaults d)
         return "spectrumScopeScale";
     case sourceEditorType:
         return "sourceEditorType";
+    case renderThreads:
+        return "renderThreads";
+    case cpuBudget:
+        return "cpuBudget";
     case numDefaults:
     {
         SXSNLOG("Software Error - defaults found");
@@ -0,0 +1,148 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#include "catch2/catch2.hpp"
+#include "synth/synth.h"
+#include "synth/matrix_index.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+using namespace baconpaul::six_sines;
+
+/*
+ * ORR_ADAPTIVE renders the same patch as ORR_FULL apart from the interpolated
+ * samples of the ops it reduces. Render both, and compare the spectrum of their
+ * difference at the host rate with the spectrum of the full rate render.
+ */
+namespace
+{
+// A three op PM stack, op 1 into op 2 into op 3, with op 3 to the main out
+void configureStack(Patch &patch, float pmLevel, OpRenderRate rate)
+{
+    patch.output.opRenderRate.value = (float)rate;
+    patch.output.velSensitivity.value = 0.f;
+
+    for (int i = 0; i < (int)numOps; ++i)
+    {
+        auto &s = patch.sourceNodes[i];
+        s.active.value = i < 3 ? 1.f : 0.f;
+        s.waveForm.value = (float)SinTable::SIN;
+        s.ratio.value = i == 1 ? 1.f : 0.f; // op 2 an octave up
+
+        patch.mixerNodes[i].active.value = i == 2 ? 1.f : 0.f;
+        patch.mixerNodes[i].level.value = 0.7f;
+        patch.selfNodes[i].active.value = 0.f;
+    }
+
+    for (int i = 0; i < (int)matrixSize; ++i)
+    {
+        auto &mx = patch.matrixNodes[i];
+        auto src = MatrixIndex::sourceIndexAt(i);
+        auto tgt = MatrixIndex::targetIndexAt(i);
+        mx.active.value = (src + 1 == tgt && tgt < 3) ? 1.f : 0.f;
+        mx.level.value = pmLevel;
+        mx.modulationMode.value = 0.f; // phase modulation
+    }
+}
+
+std::vector<float> renderChord(float pmLevel, OpRenderRate rate, const std::vector<int> &keys)
+{
+    auto synth = std::make_unique<Synth>(false);
+    configureStack(synth->patch, pmLevel, rate);
+    synth->setSampleRate(48000);
+    synth->reapplyControlSettings();
+
+    static constexpr uint32_t hostFrames{256}, hostBlocks{96};
+    float L[hostFrames], R[hostFrames];
+    float *outs[2]{L, R};
+
+    std::vector<float> res;
+    for (uint32_t b = 0; b < hostBlocks; ++b)
+    {
+        synth->processBlock(hostFrames, outs, nullptr, nullptr, nullptr,
+                            [&](uint32_t)
+                            {
+                                if (b == 0)
+                                    for (auto k : keys)
+                                        synth->voiceManager->processNoteOnEvent(0, 0, k, -1,
+                                                                                0.8f, 0.f);
+                                return std::numeric_limits<uint32_t>::max();
+                            });
+        synth->onMainThread();
+        res.insert(res.end(), L, L + hostFrames);
+    }
+    return res;
+}
+
+// Hann windowed power spectrum in dB of n samples from the end of x
+std::vector<double> spectrumDb(const std::vector<float> &x, size_t n)
+{
+    auto start = x.size() - n;
+    std::vector<double> res(n / 2);
+    for (size_t k = 0; k < n / 2; ++k)
+    {
+        std::complex<double> acc{0, 0};
+        for (size_t i = 0; i < n; ++i)
+        {
+            auto w = 0.5 - 0.5 * std::cos(2 * M_PI * i / n);
+            acc += w * x[start + i] * std::polar(1.0, -2 * M_PI * k * i / n);
+        }
+        res[k] = 10 * std::log10(std::norm(acc) + 1e-30);
+    }
+    return res;
+}
+} // namespace
+
+TEST_CASE("Adaptive operator rate against full rate", "[adaptive_rate]")
+{
+    static constexpr size_t fftSize{4096};
+    static constexpr double thresholdDb{-60};
+
+    SECTION("Bass stack reduces and stays under the threshold")
+    {
+        std::vector<int> keys{36, 43, 48};
+        auto full = renderChord(0.2f, ORR_FULL, keys);
+        auto adaptive = renderChord(0.2f, ORR_ADAPTIVE, keys);
+        REQUIRE(full.size() == adaptive.size());
+        // Different at all means the reduced path ran
+        REQUIRE(std::memcmp(full.data(), adaptive.data(), full.size() * sizeof(float)) != 0);
+
+        std::vector<float> diff(full.size());
+        for (size_t i = 0; i < full.size(); ++i)
+            diff[i] = adaptive[i] - full[i];
+
+        auto sig = spectrumDb(full, fftSize);
+        auto err = spectrumDb(diff, fftSize);
+        auto sigPeak = *std::max_element(sig.begin(), sig.end());
+        auto errPeak = *std::max_element(err.begin(), err.end());
+        INFO("signal peak " << sigPeak << " dB, error peak " << errPeak << " dB");
+        REQUIRE(sigPeak > errPeak);
+        REQUIRE(errPeak - sigPeak < thresholdDb);
+    }
+
+    SECTION("A bright stack stays at the full rate")
+    {
+        std::vector<int> keys{108, 110};
+        auto full = renderChord(1.f, ORR_FULL, keys);
+        auto adaptive = renderChord(1.f, ORR_ADAPTIVE, keys);
+        REQUIRE(full.size() == adaptive.size());
+        REQUIRE(std::memcmp(full.data(), adaptive.data(), full.size() * sizeof(float)) == 0);
+    }
+}
@@ -3,6 +3,8 @@
 #include "presets/preset-manager.h"
 #include "clap/clap.h"
 #include <cmrc/cmrc.hpp>
+#include <chrono>
+#include <thread>
 
 CMRC_DECLARE(sixsines_patches);
 
@@ -68,3 +70,115 @@ TEST_CASE("All factory patches load", "[factory]")
 
     plugin->destroy(plugin);
 }
+
+TEST_CASE("Factory patches survive the binary state", "[factory]")
+{
+    auto host = makeFactoryTestHost();
+    auto *plugin = baconpaul::six_sines::makePlugin(&host, false);
+    REQUIRE(plugin != nullptr);
+    plugin->init(plugin);
+
+    auto fs = cmrc::sixsines_patches::get_filesystem();
+    const auto factoryPath = std::string(presets::PresetManager::factoryPath);
+
+    size_t xmlBytes{0}, binaryBytes{0};
+    for (const auto &cat : fs.iterate_directory(factoryPath))
+    {
+        if (!cat.is_directory())
+            continue;
+        auto catPath = factoryPath + "/" + cat.filename();
+        for (const auto &p : fs.iterate_directory(catPath))
+        {
+            auto fullPath = catPath + "/" + p.filename();
+            auto file = fs.open(fullPath);
+            auto data = std::string(file.begin(), file.end());
+            INFO("Round tripping " << fullPath);
+
+            auto fromXml = std::make_unique<Patch>();
+            REQUIRE(fromXml->fromState(data));
+            auto bin = fromXml->toBinaryState(false);
+            REQUIRE(Patch::isBinaryState(bin.data(), bin.size()));
+            REQUIRE(!Patch::isBinaryState(data.data(), data.size()));
+
+            auto fromBin = std::make_unique<Patch>();
+            REQUIRE(fromBin->fromAnyState(bin));
+
+            REQUIRE(std::string(fromBin->name) == std::string(fromXml->name));
+            REQUIRE(std::string(fromBin->author) == std::string(fromXml->author));
+            for (size_t i = 0; i < numMacros; ++i)
+                REQUIRE(std::string(fromBin->macroNames[i].data()) ==
+                        std::string(fromXml->macroNames[i].data()));
+
+            REQUIRE(fromBin->params.size() == fromXml->params.size());
+            for (size_t i = 0; i < fromXml->params.size(); ++i)
+            {
+                INFO("Param " << fromXml->params[i]->meta.name);
+                REQUIRE(fromBin->params[i]->value == fromXml->params[i]->value);
+            }
+
+            xmlBytes += data.size();
+            binaryBytes += bin.size();
+        }
+    }
+
+    REQUIRE(binaryBytes > 0);
+    REQUIRE(binaryBytes < xmlBytes);
+
+    plugin->destroy(plugin);
+}
+
+TEST_CASE("Prefetched factory patches match a direct load", "[factory]")
+{
+    auto host = makeFactoryTestHost();
+    auto *plugin = baconpaul::six_sines::makePlugin(&host, false);
+    REQUIRE(plugin != nullptr);
+    plugin->init(plugin);
+
+    auto fs = cmrc::sixsines_patches::get_filesystem();
+    const auto factoryPath = std::string(presets::PresetManager::factoryPath);
+
+    std::vector<std::pair<std::string, std::string>> some;
+    for (const auto &cat : fs.iterate_directory(factoryPath))
+    {
+        if (!cat.is_directory())
+            continue;
+        for (const auto &p : fs.iterate_directory(factoryPath + "/" + cat.filename()))
+        {
+            some.emplace_back(cat.filename(), p.filename());
+            break;
+        }
+    }
+    REQUIRE(some.size() > 1);
+
+    auto prefetcher = std::make_unique<presets::PresetPrefetcher>();
+    std::vector<presets::PresetPrefetcher::Request> reqs;
+    for (const auto &[c, p] : some)
+        reqs.push_back(presets::PresetPrefetcher::factoryRequest(c, p));
+    prefetcher->prefetch(reqs);
+
+    for (const auto &r : reqs)
+    {
+        INFO("Prefetching " << r.key);
+        std::shared_ptr<const PatchImage> img;
+        for (int i = 0; i < 500 && !img; ++i)
+        {
+            img = prefetcher->take(r);
+            if (!img)
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        REQUIRE(img);
+
+        auto file = fs.open(factoryPath + "/" + r.cat + "/" + r.pat);
+        auto direct = std::make_unique<Patch>();
+        REQUIRE(direct->fromState(std::string(file.begin(), file.end())));
+
+        auto applied = std::make_unique<Patch>();
+        presets::PresetManager::applyImage(*applied, *img);
+        REQUIRE(std::string(applied->name) == std::string(direct->name));
+        for (size_t i = 0; i < direct->params.size(); ++i)
+            REQUIRE(applied->params[i]->value == direct->params[i]->value);
+    }
+
+    prefetcher.reset();
+    plugin->destroy(plugin);
+}
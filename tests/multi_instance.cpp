@@ -0,0 +1,112 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#include "catch2/catch2.hpp"
+#include "synth/synth.h"
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace baconpaul::six_sines;
+
+/*
+ * Hosts run plugin instances on parallel audio threads, so nothing one Synth does
+ * on its audio thread may touch state another can see. Each thread here owns a
+ * whole Synth, from construction to destruction, and plays the same notes. Any
+ * shared mutable state shows up as a hash that differs from a render done alone,
+ * and under a -DUSE_TSAN=ON build as a reported race.
+ */
+namespace
+{
+uint64_t renderInstance(int hostBlocks, const std::atomic<bool> &go)
+{
+    auto synth = std::make_unique<Synth>(false);
+    synth->setSampleRate(48000);
+
+    // Exercise the patch-load path too, as a preset load on each instance would
+    synth->installPatchImage(new PatchImage(synth->patch, "Stress"));
+    synth->freeRetiredPatchImages();
+
+    while (!go.load(std::memory_order_acquire))
+        std::this_thread::yield();
+
+    static constexpr uint32_t hostFrames{256};
+    float L[hostFrames], R[hostFrames];
+    float *outs[2]{L, R};
+
+    uint64_t hash{1469598103934665603ULL};
+    for (int b = 0; b < hostBlocks; ++b)
+    {
+        // A note on at the top of every fourth buffer, released part way through
+        // the third, so voices start, steal and release throughout
+        auto key = 48 + (b / 4) % 24;
+        auto sent{false};
+        synth->processBlock(hostFrames, outs, nullptr, nullptr, nullptr,
+                            [&](uint32_t t)
+                            {
+                                if (!sent && b % 4 == 0)
+                                {
+                                    synth->voiceManager->processNoteOnEvent(0, 0, key, -1, 0.8f,
+                                                                            0.f);
+                                    sent = true;
+                                }
+                                if (!sent && b % 4 == 2)
+                                {
+                                    if (t < 131)
+                                        return (uint32_t)131;
+                                    synth->voiceManager->processNoteOffEvent(0, 0, key, -1, 0.f);
+                                    sent = true;
+                                }
+                                return std::numeric_limits<uint32_t>::max();
+                            });
+        synth->onMainThread();
+
+        for (uint32_t i = 0; i < hostFrames; ++i)
+        {
+            uint32_t bits[2];
+            std::memcpy(&bits[0], &L[i], sizeof(float));
+            std::memcpy(&bits[1], &R[i], sizeof(float));
+            hash = (hash ^ bits[0]) * 1099511628211ULL;
+            hash = (hash ^ bits[1]) * 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+} // namespace
+
+TEST_CASE("Concurrent instances render independently", "[multi_instance]")
+{
+    static constexpr int hostBlocks{400};
+    static constexpr int instances{4};
+
+    std::atomic<bool> goNow{true};
+    auto alone = renderInstance(hostBlocks, goNow);
+    REQUIRE(alone != 0);
+
+    std::atomic<bool> go{false};
+    std::vector<uint64_t> hashes(instances, 0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < instances; ++i)
+        threads.emplace_back([&, i]() { hashes[i] = renderInstance(hostBlocks, go); });
+    go.store(true, std::memory_order_release);
+    for (auto &t : threads)
+        t.join();
+
+    for (auto h : hashes)
+        REQUIRE(h == alone);
+}
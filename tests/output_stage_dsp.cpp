@@ -1,6 +1,7 @@
 /*
  * Output-stage DSP regression tests. Pin numeric output of the saturator
- * shapers and the ZOH bit-rate decimator so they don't drift.
+ * shapers, the ZOH bit-rate decimator and the Lanczos bus decimator so they
+ * don't drift.
  */
 
 #include "catch2/catch2.hpp"
@@ -8,6 +9,8 @@
 
 #include <array>
 #include <cmath>
+#include <memory>
+#include <vector>
 
 using baconpaul::six_sines::Synth;
 
@@ -132,3 +135,118 @@ TEST_CASE("ZOHRateDownsampler golden", "[output_stage]")
             REQUIRE(in[i] == Approx(expected[i]));
     }
 }
+
+TEST_CASE("PolyphaseDecimator", "[output_stage]")
+{
+    using namespace baconpaul::six_sines;
+    static constexpr int nCh{2 * (1 + numOps)};
+    using dec_t = PolyphaseDecimator<nCh>;
+
+    SECTION("ratios it takes")
+    {
+        auto d = std::make_unique<dec_t>();
+        REQUIRE(d->setRates(120000, 48000, nCh)); // 2.5x, two phases
+        REQUIRE(d->q == 2);
+        REQUIRE(d->setRates(132300, 44100, 2)); // 3x
+        REQUIRE(d->q == 1);
+        REQUIRE(d->setRates(240000, 96000, nCh)); // 5x at a 96k host is 2.5
+        REQUIRE_FALSE(d->setRates(120000, 44123, 2)); // far too many phases
+        REQUIRE_FALSE(d->setRates(48000, 96000, 2));  // not a decimation
+    }
+
+    SECTION("every bus tracks its own sine")
+    {
+        // Each channel a different sine; output k sits at input frame k * ratio - 1
+        for (auto [er, hr] : std::vector<std::pair<int, int>>{{120000, 48000}, {176400, 44100}})
+        {
+            auto d = std::make_unique<dec_t>();
+            REQUIRE(d->setRates(er, hr, nCh));
+
+            auto freq = [](int c) { return 500.0 + 250.0 * c; };
+            float in[nCh][blockSize];
+            std::vector<std::vector<float>> out(nCh, std::vector<float>(2048));
+            float *outs[nCh];
+            for (int c = 0; c < nCh; ++c)
+                outs[c] = out[c].data();
+
+            int64_t n{0};
+            for (int produced = 0; produced < 2048; produced += blockSize)
+            {
+                while (!d->canProduce(blockSize))
+                {
+                    for (int i = 0; i < blockSize; ++i, ++n)
+                        for (int c = 0; c < nCh; ++c)
+                            in[c][i] = std::sin(2 * M_PI * freq(c) * n / er);
+                    d->push(in);
+                }
+                d->produce(outs, blockSize, produced);
+            }
+
+            for (int k = 64; k < 2048; ++k)
+            {
+                auto t = k * (double)er / hr - 1;
+                for (int c = 0; c < nCh; ++c)
+                {
+                    auto expected = std::sin(2 * M_PI * freq(c) * t / er);
+                    REQUIRE(out[c][k] == Approx(expected).margin(1e-3));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("IntegerDecimator", "[output_stage]")
+{
+    using namespace baconpaul::six_sines;
+    using dec_t = IntegerDecimator<2>;
+
+    SECTION("whole ratios only")
+    {
+        auto d = std::make_unique<dec_t>();
+        REQUIRE(d->setRates(192000, 96000, 2));
+        REQUIRE(d->nStages == 1);
+        REQUIRE(d->setRates(192000, 48000, 2)); // two half-bands
+        REQUIRE(d->nStages == 2);
+        REQUIRE(d->setRates(240000, 48000, 2)); // one five stage
+        REQUIRE(d->nStages == 1);
+        REQUIRE_FALSE(d->setRates(240000, 96000, 2));
+        REQUIRE_FALSE(d->setRates(120000, 48000, 2));
+    }
+
+    SECTION("passes below 0.4 and rejects above 0.6 of the host rate")
+    {
+        // Steady state output level in dB of a unit sine at f times the host rate
+        auto levelDb = [](int er, int hr, double f)
+        {
+            auto d = std::make_unique<dec_t>();
+            REQUIRE(d->setRates(er, hr, 2));
+            float in[2][blockSize];
+            std::vector<float> out(2048);
+            float *outs[2]{out.data(), out.data()};
+            int64_t n{0};
+            for (int produced = 0; produced < 2048; produced += blockSize)
+            {
+                while (!d->canProduce(blockSize))
+                {
+                    for (int i = 0; i < blockSize; ++i, ++n)
+                        in[0][i] = in[1][i] = std::sin(2 * M_PI * f * hr * n / er);
+                    d->push(in);
+                }
+                d->produce(outs, blockSize, produced);
+            }
+            double sq{0};
+            for (int k = 1024; k < 2048; ++k)
+                sq += out[k] * out[k];
+            return 10 * std::log10(2 * sq / 1024 + 1e-30);
+        };
+
+        for (auto [er, hr] : std::vector<std::pair<int, int>>{
+                 {192000, 96000}, {192000, 48000}, {144000, 48000}, {240000, 48000}})
+        {
+            REQUIRE(levelDb(er, hr, 0.1) == Approx(0).margin(0.01));
+            REQUIRE(levelDb(er, hr, 0.4) == Approx(0).margin(0.01));
+            REQUIRE(levelDb(er, hr, 0.6) < -70);
+            REQUIRE(levelDb(er, hr, 0.9) < -70);
+        }
+    }
+}
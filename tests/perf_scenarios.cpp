@@ -30,11 +30,22 @@
 #include "dsp/op_source.h"
 #include "dsp/sintable.h"
 #include "dsp/matrix_node.h"
+#include "dsp/integer_decimator.h"
+#include "presets/preset-manager.h"
 
+#include <cmrc/cmrc.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
+CMRC_DECLARE(sixsines_patches);
+
 using namespace baconpaul::six_sines;
 using namespace baconpaul::six_sines::perf;
 
@@ -52,6 +63,18 @@ struct ScenarioSpec
     bool allSelfFB{false};  // all 6 self-feedback nodes active
     bool fullMod{false};    // 1 mod slot populated on every node
     Patch::SourceNode::ExtendedMode em{Patch::SourceNode::ExtendedMode::NONE};
+    bool packVoices{true}; // Synth::packVoicesForRender; off gives the per-voice "before"
+    EventTiming eventTiming{ET_BLOCK};
+    int renderThreads{1}; // Synth::setRenderThreads; 1 keeps voices on the audio thread
+    bool sparse{false};   // every node stays active but only the last two ops carry level
+    bool multiOut{false}; // the Seven Sines build, with a stereo bus per op
+    bool editorAttached{false}; // meters run, as they do with the UI open
+    bool stepLfos{false}; // every LFO on the Step shape, mixers and edges listening to it
+    bool reuseHeldBlocks{true}; // MonoValues::reuseHeldBlocks; off gives the "before"
+    uint32_t statsSampleEvery{EngineStats::defaultStageSampleEvery}; // 0 times no stage
+    ResamplerEngine resampler{ResamplerEngine::SRC_FAST}; // engine to host rate
+    SampleRateStrategy srStrategy{SampleRateStrategy::SR_110120};
+    OpRenderRate opRate{ORR_FULL};
 };
 
 // ---------------------------------------------------------------------------
@@ -137,6 +160,10 @@ void configureScenarioPatch(Patch &patch, const ScenarioSpec &spec)
     patch.output.fineTune.value = 0.f;
     patch.output.pan.value = 0.f;
     patch.output.lfoDepth.value = 0.f;
+    patch.output.eventTiming.value = (float)spec.eventTiming;
+    patch.output.resampleEngine.value = (float)spec.resampler;
+    patch.output.sampleRateStrategy.value = (float)spec.srStrategy;
+    patch.output.opRenderRate.value = (float)spec.opRate;
     setFastSustainedEnv(patch.output);
     setActiveLFO(patch.output);
 
@@ -251,6 +278,42 @@ void configureScenarioPatch(Patch &patch, const ScenarioSpec &spec)
         mn.macroPower.value = 0.f; // off — voiceValues.macroOut falls back to mono macroPtr
     }
 
+    // ---- Sparse: a patch edited down to a two op stack without switching the
+    // rest off. Only the last mixer and the edge into the last op keep a level.
+    if (spec.sparse)
+    {
+        for (int i = 0; i < (int)numOps - 1; ++i)
+            patch.mixerNodes[i].level.value = 0.f;
+        for (int i = 0; i < (int)matrixSize; ++i)
+        {
+            if (MatrixIndex::sourceIndexAt(i) != numOps - 2 ||
+                MatrixIndex::targetIndexAt(i) != numOps - 1)
+                patch.matrixNodes[i].level.value = 0.f;
+        }
+    }
+
+    // ---- Step LFOs: the sequencer path, run by the mixers and matrix edges ----
+    if (spec.stepLfos)
+    {
+        auto toStep = [](Patch::LFOMixin &l)
+        {
+            l.lfoShape.value = (float)Patch::LFOMixin::Shape::Step;
+            for (size_t i = 0; i < numSeqSteps; ++i)
+                l.lfoSeqSteps[i].value = (i % 2) ? 0.5f : -0.5f;
+            l.lfoStepCount.value = (float)numSeqSteps;
+        };
+        for (auto &m : patch.mixerNodes)
+        {
+            toStep(m);
+            m.lfoToLevel.value = 0.1f;
+        }
+        for (auto &mx : patch.matrixNodes)
+        {
+            toStep(mx);
+            mx.lfoToDepth.value = 0.05f;
+        }
+    }
+
     // ---- Output mod nodes (panMod, fineTuneMod) — leave default-off ----
     // Patch ctor already constructs fineTuneMod and mainPanMod with sane defaults.
 }
@@ -264,9 +327,16 @@ void configureScenarioPatch(Patch &patch, const ScenarioSpec &spec)
 std::unique_ptr<Synth> bringUpSynth(const ScenarioSpec &spec, int numVoices,
                                     double hostSampleRate = 48000.0)
 {
-    auto s = std::make_unique<Synth>(false);
+    auto s = std::make_unique<Synth>(spec.multiOut);
+    s->isEditorAttached = spec.editorAttached;
     s->setSampleRate(hostSampleRate);
     configureScenarioPatch(s->patch, spec);
+    s->packVoicesForRender = spec.packVoices;
+    s->monoValues.reuseHeldBlocks = spec.reuseHeldBlocks;
+    s->stats.setStageSampleEvery(spec.statsSampleEvery);
+    s->setRenderThreads(spec.renderThreads);
+    if (spec.eventTiming == ET_SAMPLE_ACCURATE)
+        s->prepareStartDelayLines(); // as activate does
     // reapplyControlSettings is public and re-reads playMode/polyLimit/MPE etc
     // from the patch we just configured.
     s->reapplyControlSettings();
@@ -296,6 +366,53 @@ auto makePluginDriver(Synth &s)
     return [&s]() { s.process(nullptr); };
 }
 
+// Host-buffer level: Synth::processBlock over a whole host buffer with no
+// events, the way the CLAP process() drives it. samplesPerBlock = hostFrames.
+static constexpr uint32_t hostFrames{512};
+auto makeHostBufferDriver(Synth &s)
+{
+    auto buf = std::make_shared<std::vector<float>>(2 * (1 + numOps) * hostFrames);
+    return [&s, buf]()
+    {
+        float *outs[2 * (1 + numOps)];
+        for (int c = 0; c < 2 * (1 + numOps); ++c)
+            outs[c] = buf->data() + c * hostFrames;
+        s.processBlock(hostFrames, outs, nullptr, nullptr, nullptr,
+                       [](uint32_t) { return std::numeric_limits<uint32_t>::max(); });
+    };
+}
+
+// Host-buffer level with a steady stream of note events at unaligned frames,
+// so the event dispatch cost shows up. Each buffer starts a short note at
+// eight offsets and ends the previous one, rotating keys.
+auto makeHostEventDriver(Synth &s)
+{
+    auto buf = std::make_shared<std::vector<float>>(2 * (1 + numOps) * hostFrames);
+    auto key = std::make_shared<int>(48);
+    return [&s, buf, key]()
+    {
+        static constexpr uint32_t eventFrames[] = {3, 61, 130, 197, 258, 333, 389, 450};
+        float *outs[2 * (1 + numOps)];
+        for (int c = 0; c < 2 * (1 + numOps); ++c)
+            outs[c] = buf->data() + c * hostFrames;
+        size_t nextIdx{0};
+        s.processBlock(hostFrames, outs, nullptr, nullptr, nullptr,
+                       [&](uint32_t t)
+                       {
+                           while (nextIdx < std::size(eventFrames) && eventFrames[nextIdx] <= t)
+                           {
+                               s.voiceManager->processNoteOffEvent(0, 0, *key, -1, 0.f);
+                               *key = 48 + (*key - 47) % 24;
+                               s.voiceManager->processNoteOnEvent(0, 0, *key, -1, 0.8f, 0.f);
+                               nextIdx++;
+                           }
+                           return nextIdx < std::size(eventFrames)
+                                      ? eventFrames[nextIdx]
+                                      : std::numeric_limits<uint32_t>::max();
+                       });
+    };
+}
+
 // Voice-level: skip SRC and filter tail. Replicates only the pre-voice setup
 // `processInternal` does so renderBlock sees the same monoValues state.
 // samplesPerBlock = blockSize at the *engine* rate.
@@ -355,6 +472,8 @@ uint64_t hashOneOutputBlock(Synth &s)
 enum class Level
 {
     Plugin,
+    Host,
+    HostEvents,
     Voice,
     Inner
 };
@@ -364,6 +483,10 @@ const char *levelName(Level l)
     {
     case Level::Plugin:
         return "plugin";
+    case Level::Host:
+        return "host";
+    case Level::HostEvents:
+        return "host_events";
     case Level::Voice:
         return "voice";
     case Level::Inner:
@@ -381,12 +504,14 @@ struct RunOptions
     int samples{15};
     int warmup{3};
     double target_sample_ms{100.0};
+    const char *notes{""}; // passed through to the digest
+    double hostSampleRate{48000.0};
 };
 
 void runScenario(const char *tag, Level level, const ScenarioSpec &spec, int numVoices,
                  RunOptions opts = {})
 {
-    auto synth = bringUpSynth(spec, numVoices);
+    auto synth = bringUpSynth(spec, numVoices, opts.hostSampleRate);
 
     uint64_t hash = hashOneOutputBlock(*synth);
 
@@ -396,6 +521,14 @@ void runScenario(const char *tag, Level level, const ScenarioSpec &spec, int num
     case Level::Plugin:
         r = timeIt(opts.samples, opts.warmup, opts.target_sample_ms, makePluginDriver(*synth));
         break;
+    case Level::Host:
+        r = timeIt(opts.samples, opts.warmup, opts.target_sample_ms,
+                   makeHostBufferDriver(*synth));
+        break;
+    case Level::HostEvents:
+        r = timeIt(opts.samples, opts.warmup, opts.target_sample_ms,
+                   makeHostEventDriver(*synth));
+        break;
     case Level::Voice:
         r = timeIt(opts.samples, opts.warmup, opts.target_sample_ms, makeVoiceDriver(*synth));
         break;
@@ -410,10 +543,12 @@ void runScenario(const char *tag, Level level, const ScenarioSpec &spec, int num
     d.voices = numVoices;
     d.activeOps = spec.activeOps;
     d.block_ns = r.median_ns_per_iter;
-    d.samplesPerBlock = blockSize;
+    d.samplesPerBlock =
+        (level == Level::Host || level == Level::HostEvents) ? (int)hostFrames : blockSize;
     d.stddev_pct = r.stddev_pct;
     d.iters_per_sample = r.iters_per_sample;
     d.hash = hash;
+    d.notes = opts.notes;
     printDigest(d);
 
     // Catch2 sanity: at least confirm we got non-trivial timing and a real hash.
@@ -457,6 +592,63 @@ TEST_CASE("8 voice, dense", "[bench][plugin][scn:8v_dense]")
     runScenario("scn:8v_dense", Level::Plugin, spec, 8);
 }
 
+// 8v_dense with the mixer and matrix LFOs on the Step shape. Once the notes
+// reach sustain the envelopes hold and the steps are copied only when a param
+// moves, so this should sit close to 8v_dense rather than above it.
+TEST_CASE("8 voice, dense, step LFOs", "[bench][plugin][scn:8v_dense_step]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    spec.stepLfos = true;
+
+    {
+        auto synth = bringUpSynth(spec, 1);
+        for (int i = 0; i < 512; ++i) // well past the attack
+            hashOneOutputBlock(*synth);
+        auto *cv = synth->head;
+        REQUIRE(cv != nullptr);
+        for (auto &m : cv->mixerNode)
+        {
+            REQUIRE(m.runLfo);
+            REQUIRE(m.envHeld);
+        }
+    }
+
+    runScenario("scn:8v_dense_step", Level::Plugin, spec, 8);
+}
+
+// The "before" half of the held-block comparison for 8v_dense and 8v_dense_step:
+// every envelope and step copy recomputed each block. Holding them must not change
+// the audio, so check the hashes agree well into the sustain before timing. Digest
+// tags scn:8v_dense_recompute and scn:8v_dense_step_recompute.
+TEST_CASE("8 voice, dense, held blocks recomputed", "[bench][plugin][scn:8v_dense_recompute]")
+{
+    for (auto step : {false, true})
+    {
+        ScenarioSpec spec{};
+        spec.activeOps = 6;
+        spec.fullMatrix = true;
+        spec.allSelfFB = true;
+        spec.fullMod = true;
+        spec.stepLfos = step;
+
+        {
+            auto reused = bringUpSynth(spec, 8);
+            spec.reuseHeldBlocks = false;
+            auto recomputed = bringUpSynth(spec, 8);
+            for (int i = 0; i < 1024; ++i)
+                REQUIRE(hashOneOutputBlock(*reused) == hashOneOutputBlock(*recomputed));
+        }
+
+        spec.reuseHeldBlocks = false;
+        runScenario(step ? "scn:8v_dense_step_recompute" : "scn:8v_dense_recompute",
+                    Level::Plugin, spec, 8);
+    }
+}
+
 TEST_CASE("32 voice, dense", "[bench][plugin][scn:32v_dense]")
 {
     ScenarioSpec spec{};
@@ -477,6 +669,139 @@ TEST_CASE("64 voice, dense", "[bench][plugin][scn:64v_dense]")
     runScenario("scn:64v_dense", Level::Plugin, spec, 64);
 }
 
+// The "before" half of the voice-packing comparison: scn:64v_dense renders in
+// packs of SinTable::lanes, this renders each voice on its own. Packing must not
+// change the audio, so check the hashes agree before timing.
+TEST_CASE("64 voice, dense, unpacked", "[bench][plugin][scn:64v_dense_unpacked]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+
+    {
+        auto packed = bringUpSynth(spec, 64);
+        spec.packVoices = false;
+        auto unpacked = bringUpSynth(spec, 64);
+        for (int i = 0; i < 16; ++i)
+            REQUIRE(hashOneOutputBlock(*packed) == hashOneOutputBlock(*unpacked));
+    }
+
+    runScenario("scn:64v_dense_unpacked", Level::Plugin, spec, 64);
+}
+
+// The cost of the always-on EngineStats on the lightest patches, where its clock
+// reads are the largest share of an engine block. Each of minimal and 1v_dense is
+// run with no stage timing, with every engine block timed and with the default
+// sampling; digest tags scn:<patch>_stats_<every>, so _stats_0 is the "without".
+// Stats only observe, so every run must hash the same.
+TEST_CASE("engine stats overhead", "[bench][plugin][scn:stats_overhead]")
+{
+    for (auto dense : {false, true})
+    {
+        ScenarioSpec spec{};
+        spec.activeOps = dense ? 6 : 1;
+        spec.fullMatrix = dense;
+        spec.allSelfFB = dense;
+        spec.fullMod = dense;
+
+        for (auto every : {0u, 1u, EngineStats::defaultStageSampleEvery})
+        {
+            spec.statsSampleEvery = every;
+            if (every > 0)
+            {
+                auto offSpec = spec;
+                offSpec.statsSampleEvery = 0;
+                auto off = bringUpSynth(offSpec, 1);
+                auto on = bringUpSynth(spec, 1);
+                for (int i = 0; i < 16; ++i)
+                    REQUIRE(hashOneOutputBlock(*off) == hashOneOutputBlock(*on));
+            }
+
+            auto tag = std::string(dense ? "scn:1v_dense" : "scn:minimal") + "_stats_" +
+                       std::to_string(every);
+            runScenario(tag.c_str(), Level::Plugin, spec, 1);
+        }
+    }
+}
+
+// Voice render thread scaling: the 64v dense patch at 1, 2, 4 ... threads up to
+// the machine's core count, one digest line per count. Threaded renders sum the
+// voices in the same order as the audio thread alone, so every count must hash
+// identically to the single threaded synth.
+TEST_CASE("64 voice, dense, render thread scaling", "[bench][plugin][scn:64v_dense_threads]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+
+    auto hwThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    for (int n = 1; n <= std::min(hwThreads, VoiceRenderPool::maxThreads); n *= 2)
+    {
+        spec.renderThreads = n;
+        if (n > 1)
+        {
+            auto singleSpec = spec;
+            singleSpec.renderThreads = 1;
+            auto single = bringUpSynth(singleSpec, 64);
+            auto threaded = bringUpSynth(spec, 64);
+            REQUIRE(threaded->renderPool.threadCount() == n);
+            for (int i = 0; i < 16; ++i)
+                REQUIRE(hashOneOutputBlock(*single) == hashOneOutputBlock(*threaded));
+        }
+
+        auto tag = "scn:64v_dense_threads_" + std::to_string(n);
+        runScenario(tag.c_str(), Level::Plugin, spec, 64);
+    }
+}
+
+// CPU budget governor: 64v dense through host buffers with the budget set to half
+// of what the same synth measured with no budget, so it has to shed. block_ns is
+// the governed cost; the notes carry the budget, how many voices went and how
+// many are left. The hash is of the block before the budget goes on.
+TEST_CASE("64 voice, dense, cpu budget", "[bench][host][scn:64v_dense_budget]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+
+    auto synth = bringUpSynth(spec, 64);
+    auto hash = hashOneOutputBlock(*synth);
+    auto driver = makeHostBufferDriver(*synth);
+
+    auto unbudgeted = timeIt(5, 1, 50.0, driver);
+    auto bufferNs = 1e9 * hostFrames / synth->hostSampleRate;
+    auto budget = (float)(0.5 * unbudgeted.median_ns_per_iter / bufferNs);
+    synth->setCpuBudget(budget);
+
+    auto r = timeIt(15, 3, 100.0, driver);
+    REQUIRE(synth->voicesShed > 0);
+    REQUIRE(synth->voiceCount < 64);
+
+    char notes[96];
+    std::snprintf(notes, sizeof(notes), "budget_pct=%.1f shed=%u voices_left=%d", budget * 100,
+                  (unsigned)synth->voicesShed, synth->voiceCount);
+    DigestParams d{};
+    d.tag = "scn:64v_dense_budget";
+    d.level = levelName(Level::Host);
+    d.voices = 64;
+    d.activeOps = spec.activeOps;
+    d.block_ns = r.median_ns_per_iter;
+    d.samplesPerBlock = hostFrames;
+    d.stddev_pct = r.stddev_pct;
+    d.iters_per_sample = r.iters_per_sample;
+    d.hash = hash;
+    d.notes = notes;
+    printDigest(d);
+
+    REQUIRE(r.median_ns_per_iter > 0);
+}
+
 TEST_CASE("16 voice, PHASE_REMAP", "[bench][plugin][scn:em_phaseremap]")
 {
     ScenarioSpec spec{};
@@ -520,6 +845,182 @@ TEST_CASE("16 voice, dense, no self-FB (SIMD baseline)", "[bench][plugin][scn:no
     runScenario("scn:no_fb_simd", Level::Plugin, spec, 16);
 }
 
+// no_fb_simd on the adaptive operator rate. The low keys and gentle FM here keep
+// every op under OpSource::reducedRateBandwidth, so each looks up half its samples.
+TEST_CASE("16 voice, dense, no self-FB, adaptive op rate", "[bench][plugin][scn:no_fb_adaptive]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = false;
+    spec.fullMod = true;
+    spec.opRate = ORR_ADAPTIVE;
+
+    {
+        auto synth = bringUpSynth(spec, 1);
+        hashOneOutputBlock(*synth);
+        auto *cv = synth->head;
+        REQUIRE(cv != nullptr);
+        for (auto &op : cv->src)
+            REQUIRE(op.bandwidth < OpSource::reducedRateBandwidth);
+    }
+
+    runScenario("scn:no_fb_adaptive", Level::Plugin, spec, 16);
+}
+
+// Every op, mixer and matrix node is active but only ops 5 and 6 can be heard.
+// Voice::rebuildRouting should find exactly that and skip the rest; compare
+// against scn:no_fb_simd, which renders the same node count at full level.
+TEST_CASE("16 voice, sparse patch", "[bench][plugin][scn:sparse]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.sparse = true;
+
+    {
+        auto synth = bringUpSynth(spec, 1);
+        auto *cv = synth->head;
+        REQUIRE(cv != nullptr);
+        for (int i = 0; i < (int)numOps; ++i)
+            REQUIRE(cv->opLive[i] == (i >= (int)numOps - 2));
+        for (int i = 0; i < (int)matrixSize; ++i)
+        {
+            auto expected = MatrixIndex::sourceIndexAt(i) == numOps - 2 &&
+                            MatrixIndex::targetIndexAt(i) == numOps - 1;
+            REQUIRE(cv->matrixNode[i].live == expected);
+        }
+    }
+
+    runScenario("scn:sparse", Level::Plugin, spec, 16);
+}
+
+// The multi-out build: every op also sums into its own stereo bus, which feeds
+// the op VU meters when the editor is open.
+TEST_CASE("64 voice, dense, multi-out", "[bench][plugin][scn:multi_out]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    spec.multiOut = true;
+
+    // The main bus doesn't depend on the op buses being built
+    auto plainSpec = spec;
+    plainSpec.multiOut = false;
+    for (auto attached : {false, true})
+    {
+        auto plain = bringUpSynth(plainSpec, 64);
+        spec.editorAttached = attached;
+        auto multi = bringUpSynth(spec, 64);
+        for (int i = 0; i < 16; ++i)
+            REQUIRE(hashOneOutputBlock(*plain) == hashOneOutputBlock(*multi));
+    }
+
+    spec.editorAttached = false;
+    runScenario("scn:multi_out", Level::Plugin, spec, 64);
+    spec.editorAttached = true;
+    runScenario("scn:multi_out_editor", Level::Plugin, spec, 64);
+}
+
+// Multi-out with the Lanczos engine, where all fourteen channels go through one
+// PolyphaseDecimator rather than seven stereo resamplers
+TEST_CASE("64 voice, dense, multi-out, Lanczos", "[bench][plugin][scn:multi_out_lanczos]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    spec.multiOut = true;
+    spec.resampler = ResamplerEngine::LANCZOS;
+
+    auto plainSpec = spec;
+    plainSpec.multiOut = false;
+    {
+        auto plain = bringUpSynth(plainSpec, 64);
+        auto multi = bringUpSynth(spec, 64);
+        REQUIRE(multi->useDecimator);
+        for (int i = 0; i < 16; ++i)
+            REQUIRE(hashOneOutputBlock(*plain) == hashOneOutputBlock(*multi));
+    }
+
+    runScenario("scn:multi_out_lanczos", Level::Plugin, spec, 64);
+}
+
+// Level left by a full scale tone at 0.7 of the host rate once decimated from
+// engineRate. It folds to 0.3 of the host rate, so whatever remains is aliasing.
+double aliasDb(ResamplerEngine engine, int engineRate, int hostRate)
+{
+    static constexpr int outFrames{4096};
+    auto ratio = engineRate / hostRate;
+    std::vector<float> in((outFrames + 64) * ratio), out(outFrames + 64, 0.f);
+    for (size_t i = 0; i < in.size(); ++i)
+        in[i] = std::sin(2 * M_PI * 0.7 * hostRate * i / engineRate);
+
+    if (engine == ResamplerEngine::INT_DECIMATE)
+    {
+        auto d = std::make_unique<IntegerDecimator<2>>();
+        REQUIRE(d->setRates(engineRate, hostRate, 2));
+        float block[2][blockSize];
+        float *outs[2]{out.data(), out.data()};
+        int produced{0};
+        for (size_t i = 0; i + blockSize <= in.size() && produced < outFrames; i += blockSize)
+        {
+            memcpy(block[0], &in[i], sizeof(block[0]));
+            memcpy(block[1], &in[i], sizeof(block[1]));
+            d->push(block);
+            while (d->canProduce(1) && produced < outFrames)
+                d->produce(outs, 1, produced++);
+        }
+    }
+    else
+    {
+        SRC_DATA sd{};
+        sd.data_in = in.data();
+        sd.data_out = out.data();
+        sd.input_frames = (long)in.size();
+        sd.output_frames = (long)out.size();
+        sd.src_ratio = 1.0 * hostRate / engineRate;
+        src_simple(&sd, SRC_SINC_FASTEST, 1);
+    }
+
+    double sq{0};
+    for (int i = outFrames / 2; i < outFrames; ++i)
+        sq += out[i] * out[i];
+    return 10 * std::log10(2 * sq / (outFrames / 2) + 1e-30);
+}
+
+// 8v_dense with a 96k host and the 192k engine, an exact factor of two. SRC
+// Fast is the general resampler's cost; INT_DECIMATE runs the half-band
+// IntegerDecimator. The notes carry each one's alias rejection.
+TEST_CASE("resample tail: 192k engine to 96k host", "[bench][plugin][scn:int_decimate]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    spec.srStrategy = SampleRateStrategy::SR_176192;
+
+    RunOptions opts;
+    opts.hostSampleRate = 96000.0;
+
+    for (auto engine : {ResamplerEngine::SRC_FAST, ResamplerEngine::INT_DECIMATE})
+    {
+        spec.resampler = engine;
+        auto isInt = engine == ResamplerEngine::INT_DECIMATE;
+        REQUIRE(bringUpSynth(spec, 1, opts.hostSampleRate)->useIntDecimator == isInt);
+
+        char notes[64];
+        std::snprintf(notes, sizeof(notes), "alias_db=%.1f", aliasDb(engine, 192000, 96000));
+        opts.notes = notes;
+        runScenario(isInt ? "scn:int_decimate" : "scn:int_decimate_src", Level::Plugin, spec, 8,
+                    opts);
+    }
+}
+
 TEST_CASE("worst case: 64v + NOISE + everything", "[bench][plugin][scn:worst]")
 {
     ScenarioSpec spec{};
@@ -531,6 +1032,69 @@ TEST_CASE("worst case: 64v + NOISE + everything", "[bench][plugin][scn:worst]")
     runScenario("scn:worst", Level::Plugin, spec, 64);
 }
 
+// ---------------------------------------------------------------------------
+// Host-buffer level: the same 8v dense patch driven through processBlock a
+// 512 frame host buffer at a time. Compare against scn:8v_dense to see the
+// once-per-host-call overhead coming out of the per-block path. The first
+// section checks both paths render the same audio.
+// ---------------------------------------------------------------------------
+
+TEST_CASE("host buffer: 8v dense", "[bench][host][scn:host_8v_dense]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+
+    {
+        auto perBlock = bringUpSynth(spec, 8);
+        auto perHost = bringUpSynth(spec, 8);
+        std::vector<float> buf(2 * (1 + numOps) * hostFrames);
+        float *outs[2 * (1 + numOps)];
+        for (int c = 0; c < 2 * (1 + numOps); ++c)
+            outs[c] = buf.data() + c * hostFrames;
+        perHost->processBlock(hostFrames, outs, nullptr, nullptr, nullptr,
+                              [](uint32_t) { return std::numeric_limits<uint32_t>::max(); });
+        for (uint32_t b = 0; b < hostFrames / blockSize; ++b)
+        {
+            perBlock->process(nullptr);
+            REQUIRE(hashFloats(perBlock->output[0], blockSize) ==
+                    hashFloats(outs[0] + b * blockSize, blockSize));
+            REQUIRE(hashFloats(perBlock->output[1], blockSize) ==
+                    hashFloats(outs[1] + b * blockSize, blockSize));
+        }
+    }
+
+    runScenario("scn:host_8v_dense", Level::Host, spec, 8);
+}
+
+// Event timing cost: the same note stream through block-quantised and sample
+// accurate dispatch. The difference is the per-event dispatch plus the start
+// delay line on the voices each note starts.
+TEST_CASE("host buffer: 8v dense, note stream, block timing",
+          "[bench][host][scn:host_events_block]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    runScenario("scn:host_events_block", Level::HostEvents, spec, 8);
+}
+
+TEST_CASE("host buffer: 8v dense, note stream, sample accurate timing",
+          "[bench][host][scn:host_events_accurate]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    spec.eventTiming = ET_SAMPLE_ACCURATE;
+    runScenario("scn:host_events_accurate", Level::HostEvents, spec, 8);
+}
+
 // ---------------------------------------------------------------------------
 // Voice-level mirrors of a couple key scenarios — same patches, no SRC tail.
 // Useful when PERFORMANCE.md changes are voice-internal and we want to see
@@ -604,3 +1168,302 @@ TEST_CASE("inner: EM::NOISE", "[bench][inner][scn:inner_noise]")
     spec.em = Patch::SourceNode::ExtendedMode::NOISE;
     runScenario("scn:inner_noise", Level::Inner, spec, 1);
 }
+
+// ---------------------------------------------------------------------------
+// Engine block size (SIX_SINES_BLOCK_SIZE). Build the perf target at 8, 16 and
+// 32 and diff the runs: scn:block_size gives throughput on a modulation heavy
+// patch, scn:block_size_mod what the larger block costs in accuracy. Hashes
+// differ between block sizes by design.
+// ---------------------------------------------------------------------------
+
+TEST_CASE("block size: 16 voice, dense", "[bench][plugin][scn:block_size]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    auto notes = "block=" + std::to_string(blockSize);
+    RunOptions opts;
+    opts.notes = notes.c_str();
+    runScenario("scn:block_size", Level::Plugin, spec, 16, opts);
+}
+
+// An LFO used as a mod matrix source is read once per block (its last sample),
+// so the target holds that value for the whole block. The error is how far the
+// held value sits from the LFO's own per sample output, as RMS relative to the
+// LFO's RMS, for a 64Hz LFO. block_ns is the voice render cost alongside it.
+TEST_CASE("block size: stepped modulation error", "[bench][voice][scn:block_size_mod]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 1;
+    auto synth = bringUpSynth(spec, 0);
+    auto &src = synth->patch.sourceNodes[0];
+    src.lfoRate.value = 6.f; // 2^6 Hz
+    wireOneMod(src, ModMatrixConfig::Source::INTERNAL_LFO,
+               Patch::SourceNode::TargetID::DIRECT_FINE, 0.1f);
+    synth->voiceManager->processNoteOnEvent(0, 0, 60, -1, 0.8f, 0.f);
+    for (int i = 0; i < 8; ++i)
+        synth->process(nullptr);
+
+    auto *cv = synth->head;
+    REQUIRE(cv != nullptr);
+    auto driver = makeVoiceDriver(*synth);
+    const auto &lfo = cv->src[0].lfo.outputBlock;
+
+    double errSq{0}, sigSq{0};
+    for (int b = 0; b < 48000; ++b)
+    {
+        driver();
+        auto held = lfo[blockSize - 1];
+        for (int i = 0; i < (int)blockSize; ++i)
+        {
+            errSq += (lfo[i] - held) * (lfo[i] - held);
+            sigSq += lfo[i] * lfo[i];
+        }
+    }
+    REQUIRE(sigSq > 0);
+    auto errDb = 10.0 * std::log10(errSq / sigSq);
+
+    auto r = timeIt(15, 3, 100.0, driver);
+
+    char notes[64];
+    std::snprintf(notes, sizeof(notes), "block=%d mod_err_db=%.2f", (int)blockSize, errDb);
+    DigestParams d{};
+    d.tag = "scn:block_size_mod";
+    d.level = "voice";
+    d.voices = 1;
+    d.activeOps = spec.activeOps;
+    d.block_ns = r.median_ns_per_iter;
+    d.samplesPerBlock = blockSize;
+    d.stddev_pct = r.stddev_pct;
+    d.iters_per_sample = r.iters_per_sample;
+    d.hash = hashFloats(cv->output[0], blockSize);
+    d.notes = notes;
+    printDigest(d);
+
+    REQUIRE(r.median_ns_per_iter > 0);
+}
+
+// ---------------------------------------------------------------------------
+// Wave table footprint. SinTable builds each waveform's table on first use, so
+// startup pays for SIN and HANN only. block_ns is the time to build one table;
+// the notes give table memory resident now against building every waveform.
+// ---------------------------------------------------------------------------
+
+TEST_CASE("sintable: lazy build", "[bench][table][scn:sintable_lazy]")
+{
+    SinTable st;
+    auto lazyBytes = SinTable::residentTableBytes();
+    auto eagerBytes = sizeof(SinTable::simdCubic) +
+                      (SinTable::NUM_WAVEFORMS - 1) * sizeof(SinTable::simdFullQuad[0]);
+    REQUIRE(lazyBytes < eagerBytes);
+
+    // Rebuilding SIN writes the values it already holds, so nothing reading it
+    // can tell; that lets us time the build without a fresh process.
+    auto r = timeIt(15, 3, 100.0,
+                    []()
+                    {
+                        SinTable::fillTable(SinTable::SIN,
+                                            [](double x, int Q)
+                                            {
+                                                return std::make_pair(
+                                                    std::sin(2.0 * M_PI * x),
+                                                    2.0 * M_PI * std::cos(2.0 * M_PI * x));
+                                            });
+                    });
+
+    auto notes = "lazy_kb=" + std::to_string(lazyBytes / 1024) +
+                 " eager_kb=" + std::to_string(eagerBytes / 1024);
+    DigestParams d{};
+    d.tag = "scn:sintable_lazy";
+    d.level = "table";
+    d.block_ns = r.median_ns_per_iter;
+    d.samplesPerBlock = 1;
+    d.stddev_pct = r.stddev_pct;
+    d.iters_per_sample = r.iters_per_sample;
+    d.hash = hashFloats(reinterpret_cast<const float *>(SinTable::simdFullQuad[SinTable::SIN]),
+                        4 * SinTable::nQuadrants * SinTable::nPoints);
+    d.notes = notes.c_str();
+    printDigest(d);
+
+    REQUIRE(r.median_ns_per_iter > 0);
+}
+
+// ---------------------------------------------------------------------------
+// Param id lookup, as automation without a CLAP cookie takes it. block_ns is one
+// pass resolving every param id through the dense table; the notes carry the
+// same pass through paramMap for comparison.
+// ---------------------------------------------------------------------------
+
+TEST_CASE("param lookup: dense id table", "[bench][params][scn:param_lookup]")
+{
+    auto patch = std::make_unique<Patch>();
+    std::vector<uint32_t> ids;
+    for (const auto *p : patch->params)
+        ids.push_back(p->meta.id);
+    // Host automation arrives in no particular order
+    for (size_t i = 0; i < ids.size(); ++i)
+        std::swap(ids[i], ids[(i * 7919) % ids.size()]);
+
+    uintptr_t sink{0};
+    auto dense = timeIt(15, 3, 100.0,
+                        [&]()
+                        {
+                            for (auto id : ids)
+                                sink += reinterpret_cast<uintptr_t>(patch->paramById(id));
+                        });
+    auto hashed = timeIt(15, 3, 100.0,
+                         [&]()
+                         {
+                             for (auto id : ids)
+                                 sink += reinterpret_cast<uintptr_t>(patch->paramMap.at(id));
+                         });
+
+    for (auto id : ids)
+        REQUIRE(patch->paramById(id) == patch->paramMap.at(id));
+
+    char notes[128];
+    std::snprintf(notes, sizeof(notes), "params=%zu map_ns=%.1f table_kb=%zu", ids.size(),
+                  hashed.median_ns_per_iter,
+                  (patch->idPages.size() * sizeof(patch->idPages[0]) +
+                   patch->idPageOf.size() * sizeof(patch->idPageOf[0])) /
+                      1024);
+    DigestParams d{};
+    d.tag = "scn:param_lookup";
+    d.level = "params";
+    d.block_ns = dense.median_ns_per_iter;
+    d.samplesPerBlock = 1;
+    d.stddev_pct = dense.stddev_pct;
+    d.iters_per_sample = dense.iters_per_sample;
+    d.hash = sink | 1;
+    d.notes = notes;
+    printDigest(d);
+
+    REQUIRE(dense.median_ns_per_iter > 0);
+}
+
+// ---------------------------------------------------------------------------
+// Voice footprint. Voice-level render of 64v dense, with sizeof(Voice) and the
+// data cache read misses per block in the notes (n/a where the kernel won't
+// count them). Moving cold state out of the voices should show up here;
+// step_bytes is the per voice block the step LFO state moved to.
+// ---------------------------------------------------------------------------
+
+TEST_CASE("voice: 64v dense footprint", "[bench][voice][scn:voice_footprint]")
+{
+    ScenarioSpec spec{};
+    spec.activeOps = 6;
+    spec.fullMatrix = true;
+    spec.allSelfFB = true;
+    spec.fullMod = true;
+    auto synth = bringUpSynth(spec, 64);
+
+    auto hash = hashOneOutputBlock(*synth);
+    auto driver = makeVoiceDriver(*synth);
+    auto r = timeIt(15, 3, 100.0, driver);
+    auto misses = countCacheMisses(std::max(1, r.iters_per_sample), driver);
+
+    char notes[160];
+    if (misses.available)
+        std::snprintf(notes, sizeof(notes),
+                      "voice_bytes=%zu step_bytes=%zu l1d_miss=%.1f llc_miss=%.1f",
+                      sizeof(Voice), sizeof(Voice::StepStates), misses.l1dPerIter,
+                      misses.llcPerIter);
+    else
+        std::snprintf(notes, sizeof(notes),
+                      "voice_bytes=%zu step_bytes=%zu l1d_miss=n/a llc_miss=n/a",
+                      sizeof(Voice), sizeof(Voice::StepStates));
+
+    DigestParams d{};
+    d.tag = "scn:voice_footprint";
+    d.level = "voice";
+    d.voices = 64;
+    d.activeOps = spec.activeOps;
+    d.block_ns = r.median_ns_per_iter;
+    d.stddev_pct = r.stddev_pct;
+    d.iters_per_sample = r.iters_per_sample;
+    d.hash = hash;
+    d.notes = notes;
+    printDigest(d);
+
+    REQUIRE(r.median_ns_per_iter > 0);
+}
+
+// ---------------------------------------------------------------------------
+// Patch load. block_ns is one pass loading every factory patch from its binary
+// state, as stateLoad takes it; scn:patch_load_xml is the same pass through the
+// XML. The notes carry the total size of each.
+// ---------------------------------------------------------------------------
+
+TEST_CASE("patch load: xml vs binary", "[bench][patch][scn:patch_load]")
+{
+    // Bring the shared tables up as a plugin would before any patch exists
+    auto synth = std::make_unique<Synth>(false);
+
+    auto fs = cmrc::sixsines_patches::get_filesystem();
+    const auto factoryPath = std::string(presets::PresetManager::factoryPath);
+    std::vector<std::string> xml, binary;
+    for (const auto &cat : fs.iterate_directory(factoryPath))
+    {
+        if (!cat.is_directory())
+            continue;
+        auto catPath = factoryPath + "/" + cat.filename();
+        for (const auto &p : fs.iterate_directory(catPath))
+        {
+            auto file = fs.open(catPath + "/" + p.filename());
+            xml.emplace_back(file.begin(), file.end());
+            auto patch = std::make_unique<Patch>();
+            REQUIRE(patch->fromState(xml.back()));
+            binary.push_back(patch->toBinaryState(false));
+        }
+    }
+    REQUIRE(!xml.empty());
+
+    size_t xmlBytes{0}, binaryBytes{0};
+    for (size_t i = 0; i < xml.size(); ++i)
+    {
+        xmlBytes += xml[i].size();
+        binaryBytes += binary[i].size();
+    }
+
+    auto patch = std::make_unique<Patch>();
+    auto fromXml = timeIt(9, 1, 200.0,
+                          [&]()
+                          {
+                              for (const auto &x : xml)
+                                  patch->fromState(x);
+                          });
+    auto fromBinary = timeIt(9, 1, 200.0,
+                             [&]()
+                             {
+                                 for (const auto &b : binary)
+                                     patch->fromBinaryState(b.data(), b.size());
+                             });
+
+    uint64_t hash{0};
+    for (const auto *p : patch->params)
+        hash = hash * 31 + (uint64_t)(p->value * 1000);
+
+    auto emit = [&](const char *tag, const BenchResult &r, size_t bytes)
+    {
+        char notes[128];
+        std::snprintf(notes, sizeof(notes), "patches=%zu state_kb=%zu", xml.size(),
+                      bytes / 1024);
+        DigestParams d{};
+        d.tag = tag;
+        d.level = "patch";
+        d.block_ns = r.median_ns_per_iter;
+        d.samplesPerBlock = 1;
+        d.stddev_pct = r.stddev_pct;
+        d.iters_per_sample = r.iters_per_sample;
+        d.hash = hash;
+        d.notes = notes;
+        printDigest(d);
+    };
+    emit("scn:patch_load_xml", fromXml, xmlBytes);
+    emit("scn:patch_load", fromBinary, binaryBytes);
+
+    REQUIRE(binaryBytes < xmlBytes);
+    REQUIRE(fromBinary.median_ns_per_iter > 0);
+}
@@ -18,6 +18,13 @@
 #include <string>
 #include <vector>
 
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include "configuration.h"
 
 namespace baconpaul::six_sines::perf
@@ -109,6 +116,64 @@ inline BenchResult timeIt(int samples, int warmup, double target_sample_ms, Work
     return {median, min, stddev_pct, iters};
 }
 
+// Data cache read misses per call of work(), counted by the kernel around
+// `iters` calls. L1D and last level are the two cache events perf_event exposes
+// portably; there is no generic L2 one. Only Linux has the counters, and only
+// where perf_event_paranoid allows a user process to read them; otherwise
+// `available` is false and the scenario reports n/a.
+struct CacheMisses
+{
+    bool available{false};
+    double l1dPerIter{0}, llcPerIter{0};
+};
+
+template <typename Work> inline CacheMisses countCacheMisses(int iters, Work &&work)
+{
+    CacheMisses res;
+#if defined(__linux__)
+    auto open = [](uint64_t cache)
+    {
+        perf_event_attr pe{};
+        pe.type = PERF_TYPE_HW_CACHE;
+        pe.size = sizeof(pe);
+        pe.config = cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                    (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        pe.disabled = 1;
+        pe.exclude_kernel = 1;
+        pe.exclude_hv = 1;
+        return (int)syscall(__NR_perf_event_open, &pe, 0, -1, -1, 0);
+    };
+    int fds[2] = {open(PERF_COUNT_HW_CACHE_L1D), open(PERF_COUNT_HW_CACHE_LL)};
+    if (fds[0] >= 0 && fds[1] >= 0)
+    {
+        for (auto fd : fds)
+        {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+        for (int k = 0; k < iters; ++k)
+            work();
+        uint64_t counts[2]{0, 0};
+        bool ok{true};
+        for (int i = 0; i < 2; ++i)
+        {
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            ok = ok && read(fds[i], &counts[i], sizeof(counts[i])) == sizeof(counts[i]);
+        }
+        if (ok)
+        {
+            res.available = true;
+            res.l1dPerIter = (double)counts[0] / iters;
+            res.llcPerIter = (double)counts[1] / iters;
+        }
+    }
+    for (auto fd : fds)
+        if (fd >= 0)
+            close(fd);
+#endif
+    return res;
+}
+
 // FNV-1a over the float bytes of a buffer. Lets each scenario print a
 // signature alongside its timing so we can detect if a "no-op refactor"
 // silently changed numeric output.
@@ -0,0 +1,107 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#include "catch2/catch2.hpp"
+#include "presets/preset-index.h"
+#include <fstream>
+#include <string>
+
+using namespace baconpaul::six_sines;
+using namespace baconpaul::six_sines::presets;
+
+namespace
+{
+void writePreset(const fs::path &p, const std::string &name, const std::string &author)
+{
+    fs::create_directories(p.parent_path());
+    std::ofstream ofs(p, std::ios::binary);
+    ofs << "<patch id=\"org.baconpaul.six-sines\" version=\"6\" name=\"" << name
+        << "\" author=\"" << author << "\"><params /></patch>";
+}
+
+const PresetIndex::Entry *find(const PresetIndex::Snapshot &s, const fs::path &rel)
+{
+    for (const auto &e : s.user)
+        if (e.path == rel)
+            return &e;
+    return nullptr;
+}
+} // namespace
+
+TEST_CASE("Preset index", "[presets]")
+{
+    auto root = fs::temp_directory_path() / "six-sines-preset-index-test";
+    fs::remove_all(root);
+    auto patches = root / "Patches";
+    auto cache = root / "PresetIndex.sxsni";
+
+    writePreset(patches / "Top.sxsnp", "Top", "Someone");
+    writePreset(patches / "Bass" / "Low and Slow.sxsnp", "Low &amp; Slow", "Someone Else");
+    writePreset(patches / "Bass" / "notes.txt", "Not", "A Preset");
+
+    SECTION("Scans names, authors and categories")
+    {
+        PresetIndex idx(patches, cache);
+        idx.waitForRescan();
+        auto s = idx.snapshot();
+
+        REQUIRE(!s->factory.empty());
+        REQUIRE(s->user.size() == 2);
+        // Top level presets sort first
+        REQUIRE(s->user[0].path == fs::path("Top.sxsnp"));
+
+        auto *low = find(*s, fs::path("Bass") / "Low and Slow.sxsnp");
+        REQUIRE(low);
+        REQUIRE(low->name == "Low & Slow");
+        REQUIRE(low->author == "Someone Else");
+        REQUIRE(low->category == "Bass");
+        REQUIRE(fs::exists(cache));
+    }
+
+    SECTION("Picks up changes and reloads from the cache")
+    {
+        uint64_t firstHash{0};
+        {
+            PresetIndex idx(patches, cache);
+            idx.waitForRescan();
+            firstHash = find(*idx.snapshot(), "Top.sxsnp")->hash;
+
+            auto g = idx.generation();
+            writePreset(patches / "Top.sxsnp", "Top Renamed", "Someone");
+            writePreset(patches / "Added.sxsnp", "Added", "");
+            idx.requestRescan();
+            idx.waitForRescan();
+
+            auto s = idx.snapshot();
+            REQUIRE(idx.generation() > g);
+            REQUIRE(s->user.size() == 3);
+            REQUIRE(find(*s, "Top.sxsnp")->name == "Top Renamed");
+            REQUIRE(find(*s, "Top.sxsnp")->hash != firstHash);
+            REQUIRE(find(*s, "Added.sxsnp")->author.empty());
+        }
+
+        // A fresh index has the cached entries before its own scan finishes
+        PresetIndex again(patches, cache);
+        auto s = again.snapshot();
+        REQUIRE(s->user.size() == 3);
+        REQUIRE(find(*s, "Top.sxsnp")->name == "Top Renamed");
+
+        auto ent = again.userEntryFor(patches / "Bass" / "Low and Slow.sxsnp");
+        REQUIRE(ent.has_value());
+        REQUIRE(ent->author == "Someone Else");
+    }
+
+    fs::remove_all(root);
+}
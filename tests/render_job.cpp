@@ -0,0 +1,233 @@
+/*
+ * Six Sines
+ *
+ * A synth with audio rate modulation.
+ *
+ * Copyright 2024-2025, Paul Walker and Various authors, as described in the github
+ * transaction log.
+ *
+ * This source repo is released under the MIT license, but has
+ * GPL3 dependencies, as such the combined work will be
+ * released under GPL3.
+ *
+ * The source code and license are at https://github.com/baconpaul/six-sines
+ */
+
+#include "catch2/catch2.hpp"
+#include "render/render-job.h"
+#include <sstream>
+
+using namespace baconpaul::six_sines::render;
+
+namespace
+{
+using bytes_t = std::vector<uint8_t>;
+
+void be(bytes_t &b, uint32_t v, int n)
+{
+    for (int i = n - 1; i >= 0; --i)
+        b.push_back((uint8_t)(v >> (8 * i)));
+}
+
+// A metrical time SMF. Each track is its event bytes; the chunk length is taken
+// from them unless claimedLength says otherwise.
+bytes_t smf(uint16_t division, const std::vector<bytes_t> &tracks, uint32_t claimedLength = 0)
+{
+    bytes_t b{'M', 'T', 'h', 'd'};
+    be(b, 6, 4);
+    be(b, tracks.size() > 1 ? 1 : 0, 2);
+    be(b, (uint32_t)tracks.size(), 2);
+    be(b, division, 2);
+    for (const auto &t : tracks)
+    {
+        b.insert(b.end(), {'M', 'T', 'r', 'k'});
+        be(b, claimedLength ? claimedLength : (uint32_t)t.size(), 4);
+        b.insert(b.end(), t.begin(), t.end());
+    }
+    return b;
+}
+
+void requireEvent(const TimedMidi &e, double seconds, uint8_t s, uint8_t d1, uint8_t d2)
+{
+    REQUIRE(e.seconds == Approx(seconds));
+    REQUIRE(e.data[0] == s);
+    REQUIRE(e.data[1] == d1);
+    REQUIRE(e.data[2] == d2);
+}
+
+std::vector<TimedMidi> readScript(const std::string &text, std::string &err, bool &ok)
+{
+    std::istringstream in(text);
+    std::vector<TimedMidi> out;
+    ok = readNoteScript(in, "notes.txt", out, err);
+    return out;
+}
+} // namespace
+
+TEST_CASE("MIDI file running status and velocity zero", "[render]")
+{
+    // 96 ticks a quarter at the default 120bpm, so 96 ticks is half a second. At
+    // tick 96 the file has a note on before a running status note on at velocity
+    // 0, which is a note off and so has to come out first.
+    auto d = smf(96, {{0x00, 0x90, 0x3C, 0x64,   //
+                       0x60, 0x40, 0x64,         // running status, key 64
+                       0x00, 0x3C, 0x00,         // running status, velocity 0
+                       0x60, 0x80, 0x40, 0x00,   //
+                       0x00, 0xFF, 0x2F, 0x00}}); // end of track
+
+    std::vector<TimedMidi> ev;
+    std::string err;
+    REQUIRE(readMidiBytes(d, "a.mid", ev, err));
+    REQUIRE(ev.size() == 4);
+    requireEvent(ev[0], 0.0, 0x90, 0x3C, 0x64);
+    requireEvent(ev[1], 0.5, 0x90, 0x3C, 0x00);
+    requireEvent(ev[2], 0.5, 0x90, 0x40, 0x64);
+    requireEvent(ev[3], 1.0, 0x80, 0x40, 0x00);
+}
+
+TEST_CASE("MIDI file tempo map across merged tracks", "[render]")
+{
+    // Track 0 holds the tempo map: 120bpm, then 60bpm from tick 96. Track 1's
+    // notes are timed by it once the tracks are merged. Meta text and sysex in
+    // the stream are skipped.
+    auto tempo = bytes_t{0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20, // 500000 us
+                         0x60, 0xFF, 0x51, 0x03, 0x0F, 0x42, 0x40, // 1000000 us
+                         0x00, 0xFF, 0x2F, 0x00};
+    auto notes = bytes_t{0x00, 0xFF, 0x01, 0x02, 'h', 'i', // text
+                         0x00, 0x91, 0x3C, 0x50,           //
+                         0x00, 0xF0, 0x02, 0x7E, 0xF7,     // sysex
+                         0x81, 0x10, 0x81, 0x3C, 0x00,     // tick 144
+                         0x30, 0x91, 0x3E, 0x50,           // tick 192
+                         0x00, 0xFF, 0x2F, 0x00};
+
+    std::vector<TimedMidi> ev;
+    std::string err;
+    REQUIRE(readMidiBytes(smf(96, {tempo, notes}), "b.mid", ev, err));
+    REQUIRE(ev.size() == 3);
+    requireEvent(ev[0], 0.0, 0x91, 0x3C, 0x50);
+    requireEvent(ev[1], 1.0, 0x81, 0x3C, 0x00);
+    requireEvent(ev[2], 1.5, 0x91, 0x3E, 0x50);
+}
+
+TEST_CASE("MIDI file cut short", "[render]")
+{
+    std::vector<TimedMidi> ev;
+    std::string err;
+
+    SECTION("A track chunk longer than the file keeps its whole events")
+    {
+        auto d = smf(96, {{0x00, 0x90, 0x3C, 0x64, //
+                           0x60, 0x80, 0x3C}},     // velocity missing
+                     100);
+        REQUIRE(readMidiBytes(d, "c.mid", ev, err));
+        REQUIRE(ev.size() == 1);
+        requireEvent(ev[0], 0.0, 0x90, 0x3C, 0x64);
+    }
+
+    SECTION("A meta event running past the end is dropped")
+    {
+        auto d = smf(96, {{0x00, 0x90, 0x3C, 0x64, //
+                           0x00, 0xFF, 0x51, 0x03, 0x07}},
+                     100);
+        REQUIRE(readMidiBytes(d, "c.mid", ev, err));
+        REQUIRE(ev.size() == 1);
+    }
+
+    SECTION("More tracks declared than present")
+    {
+        auto d = smf(96, {{0x00, 0x90, 0x3C, 0x64}});
+        d[11] = 3; // nTracks
+        REQUIRE(readMidiBytes(d, "c.mid", ev, err));
+        REQUIRE(ev.size() == 1);
+    }
+
+    SECTION("A header cut short is not a MIDI file")
+    {
+        auto d = smf(96, {});
+        d.resize(10);
+        REQUIRE(!readMidiBytes(d, "c.mid", ev, err));
+        REQUIRE(err.find("not a MIDI file") != std::string::npos);
+    }
+}
+
+TEST_CASE("MIDI file errors", "[render]")
+{
+    std::vector<TimedMidi> ev;
+    std::string err;
+
+    SECTION("Not a MIDI file")
+    {
+        bytes_t d{'R', 'I', 'F', 'F', 0, 0, 0, 4, 'W', 'A', 'V', 'E'};
+        REQUIRE(!readMidiBytes(d, "d.wav", ev, err));
+        REQUIRE(err.find("'d.wav' is not a MIDI file") != std::string::npos);
+    }
+
+    SECTION("SMPTE time")
+    {
+        REQUIRE(!readMidiBytes(smf(0xE728, {}), "d.mid", ev, err));
+        REQUIRE(err.find("SMPTE") != std::string::npos);
+    }
+
+    SECTION("Running status with no status")
+    {
+        REQUIRE(!readMidiBytes(smf(96, {{0x00, 0x3C, 0x64}}), "d.mid", ev, err));
+        REQUIRE(err.find("Malformed track in 'd.mid'") != std::string::npos);
+    }
+
+    SECTION("A missing file")
+    {
+        REQUIRE(!readMidiFile("no/such/file.mid", ev, err));
+        REQUIRE(err.find("Unable to open") != std::string::npos);
+    }
+}
+
+TEST_CASE("Note script", "[render]")
+{
+    std::string err;
+    bool ok;
+
+    SECTION("Fields, defaults, comments and order")
+    {
+        auto ev = readScript("# a comment\n"
+                             "\n"
+                             "0.5 0.5 62 1.0 3\n"
+                             "  \t\r\n"
+                             "0 0.5 60\n"
+                             "1 0.25 60 0\n",
+                             err, ok);
+        REQUIRE(ok);
+        REQUIRE(ev.size() == 6);
+        requireEvent(ev[0], 0.0, 0x90, 60, 102); // round(0.8 * 127)
+        // At 0.5 the note off sorts before the note on
+        requireEvent(ev[1], 0.5, 0x80, 60, 0);
+        requireEvent(ev[2], 0.5, 0x93, 62, 127);
+        requireEvent(ev[3], 1.0, 0x83, 62, 0);
+        requireEvent(ev[4], 1.0, 0x90, 60, 1); // velocity 0 still sounds
+        requireEvent(ev[5], 1.25, 0x80, 60, 0);
+    }
+
+    SECTION("Channel is clamped")
+    {
+        auto ev = readScript("0 1 60 0.5 22\n", err, ok);
+        REQUIRE(ok);
+        REQUIRE(ev[0].data[0] == 0x9F);
+    }
+
+    SECTION("Errors name the line")
+    {
+        for (auto bad : {"0 1\n", "x 1 60\n", "-1 1 60\n", "0 -1 60\n", "0 1 128\n"})
+        {
+            INFO(bad);
+            readScript(std::string("0 1 60\n") + bad, err, ok);
+            REQUIRE(!ok);
+            REQUIRE(err == "notes.txt:2: expected 'start length key'");
+        }
+    }
+
+    SECTION("A missing file")
+    {
+        std::vector<TimedMidi> ev;
+        REQUIRE(!readNoteScript("no/such/notes.txt", ev, err));
+        REQUIRE(err.find("Unable to open") != std::string::npos);
+    }
+}
@@ -0,0 +1,166 @@
+/*
+ * SinTable lookup kernels. The batched and voice-packed lookups avoid the
+ * horizontal adds in SinTable::at but are ordered to reproduce its sums, so
+ * they must agree with it bit for bit, not just approximately.
+ */
+
+#include "catch2/catch2.hpp"
+#include "configuration.h"
+#include "dsp/sintable.h"
+
+#include <cstring>
+#include <random>
+
+using namespace baconpaul::six_sines;
+
+namespace
+{
+bool sameBits(float a, float b) { return std::memcmp(&a, &b, sizeof(float)) == 0; }
+} // namespace
+
+TEST_CASE("SinTable atBlock matches at", "[sintable]")
+{
+    std::mt19937 gen(8675309);
+    std::uniform_int_distribution<uint32_t> dist;
+
+    for (int wf = 0; wf < SinTable::AUDIO_IN; ++wf)
+    {
+        INFO("Waveform " << wf);
+        SinTable::prepareWaveForm((SinTable::WaveForm)wf);
+        SinTable st;
+        st.setWaveForm((SinTable::WaveForm)wf);
+
+        for (int trial = 0; trial < 512; ++trial)
+        {
+            uint32_t ph[blockSize];
+            for (auto &p : ph)
+                p = dist(gen);
+            // Hit the table ends and quadrant edges too
+            if (trial == 0)
+                for (int i = 0; i < (int)blockSize; ++i)
+                    ph[i] = (uint32_t)i * (phase::phaseMax / 4) - (i & 1);
+
+            float out[blockSize];
+            st.atBlock<blockSize>(ph, out);
+            for (int i = 0; i < (int)blockSize; ++i)
+                REQUIRE(sameBits(out[i], st.at(ph[i])));
+        }
+    }
+}
+
+TEST_CASE("SinTable atLanes matches at", "[sintable]")
+{
+    std::mt19937 gen(2718281);
+    std::uniform_int_distribution<uint32_t> dist;
+
+    for (auto wf : {SinTable::SQUARISH, SinTable::TX4, SinTable::TUKEY_WINDOW})
+        SinTable::prepareWaveForm(wf);
+    SinTable st[SinTable::lanes];
+    st[0].setWaveForm(SinTable::SIN);
+    st[1].setWaveForm(SinTable::SQUARISH);
+    st[2].setWaveForm(SinTable::TX4);
+    st[3].setWaveForm(SinTable::TUKEY_WINDOW);
+    const SIMD_M128 *quads[SinTable::lanes];
+    for (int l = 0; l < SinTable::lanes; ++l)
+        quads[l] = st[l].simdQuad;
+
+    for (int trial = 0; trial < 4096; ++trial)
+    {
+        uint32_t ph[SinTable::lanes];
+        for (auto &p : ph)
+            p = dist(gen);
+
+        float out alignas(16)[SinTable::lanes];
+        SIMD_MM(store_ps)(out, SinTable::atLanes(quads, ph));
+        for (int l = 0; l < SinTable::lanes; ++l)
+            REQUIRE(sameBits(out[l], st[l].at(ph[l])));
+    }
+}
+
+TEST_CASE("SinTable scaled atBlock matches at", "[sintable]")
+{
+    std::mt19937 gen(1618033);
+    std::uniform_int_distribution<uint32_t> dist;
+    std::uniform_real_distribution<float> sd(-1.f, 1.f);
+
+    SinTable::prepareWaveForm(SinTable::SAWISH);
+    SinTable st;
+    st.setWaveForm(SinTable::SAWISH);
+    for (int trial = 0; trial < 512; ++trial)
+    {
+        uint32_t ph[blockSize];
+        float scale[blockSize];
+        for (int i = 0; i < (int)blockSize; ++i)
+        {
+            ph[i] = dist(gen);
+            scale[i] = sd(gen);
+        }
+
+        float out[blockSize];
+        st.atBlock<blockSize>(ph, scale, out);
+        for (int i = 0; i < (int)blockSize; ++i)
+            REQUIRE(sameBits(out[i], st.at(ph[i]) * scale[i]));
+    }
+}
+
+TEST_CASE("SinTable dPhaseBlock matches dPhase", "[sintable]")
+{
+    std::mt19937 gen(1414213);
+    std::uniform_real_distribution<float> fq(0.01f, 20000.f);
+    std::uniform_real_distribution<float> fmd(-4.f, 4.f);
+    std::uniform_real_distribution<float> rfd(0.25f, 16.f);
+
+    for (auto sr : {44100.0, 48000.0, 96000.0, 192000.0})
+    {
+        INFO("Sample rate " << sr);
+        SinTable st;
+        st.setSampleRate(sr);
+
+        for (int trial = 0; trial < 2048; ++trial)
+        {
+            auto base = fq(gen);
+            float fm alignas(16)[blockSize], rf alignas(16)[blockSize];
+            for (int i = 0; i < (int)blockSize; ++i)
+            {
+                fm[i] = (trial & 1) ? fmd(gen) : 0.f;
+                rf[i] = rfd(gen);
+            }
+
+            int32_t dph alignas(16)[blockSize];
+            st.dPhaseBlock<blockSize>(base, fm, rf, dph);
+            for (int i = 0; i < (int)blockSize; ++i)
+                REQUIRE(dph[i] == st.dPhase((base * (1.0 + fm[i])) * rf[i]));
+        }
+    }
+}
+
+TEST_CASE("SinTable setWaveForm never builds", "[sintable]")
+{
+    SinTable st;
+    REQUIRE(SinTable::isBuilt(SinTable::SIN));
+    REQUIRE(SinTable::isBuilt(SinTable::HANN_WINDOW));
+
+    // Tables are shared by the process and may already be built by another test.
+    // Rebuilding one writes the values it already holds, so mark one unbuilt.
+    auto wf = SinTable::TX8;
+    SinTable::buildState[wf].store(SinTable::UNBUILT);
+
+    // Start with nothing outstanding
+    SinTable::serviceBuildRequests();
+    SinTable::takeBuildRequestsPosted();
+
+    REQUIRE(!st.setWaveForm(wf));
+    REQUIRE(!SinTable::isBuilt(wf));
+    REQUIRE(st.simdQuad == SinTable::simdFullQuad[SinTable::SIN]);
+    REQUIRE(!st.setWaveForm(wf, SinTable::HANN_WINDOW));
+    REQUIRE(st.simdQuad == SinTable::simdFullQuad[SinTable::HANN_WINDOW]);
+
+    // One host callback for the lot, then the main thread builds it
+    REQUIRE(SinTable::takeBuildRequestsPosted());
+    REQUIRE(!SinTable::takeBuildRequestsPosted());
+    SinTable::serviceBuildRequests();
+    REQUIRE(SinTable::isBuilt(wf));
+
+    REQUIRE(st.setWaveForm(wf));
+    REQUIRE(st.simdQuad == SinTable::simdFullQuad[wf]);
+}
@@ -1,9 +1,17 @@
 #include "catch2/catch2.hpp"
 #include "synth/patch.h"
+#include "synth/synth.h"
 #include "clap/clap.h"
 #include "clap/ext/params.h"
 #include "clapwrapper/auv2.h"
+#include "clap/engine-stats-ext.h"
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <memory>
 #include <vector>
 
 using namespace baconpaul::six_sines;
@@ -129,3 +137,472 @@ TEST_CASE("param_order_110", "[structure]")
 
     plugin->destroy(plugin);
 }
+
+/*
+ * stateSave serialises Synth::patchForStream, which copies what the audio thread last
+ * published. A param still gliding towards a new value must save as that value.
+ */
+TEST_CASE("State save snapshot", "[structure]")
+{
+    auto synth = std::make_unique<Synth>(false);
+    synth->setSampleRate(48000);
+
+    // Nothing published yet, so the live patch is what gets saved
+    REQUIRE(&synth->patchForStream() == &synth->patch);
+
+    synth->process(nullptr);
+    auto &level = synth->patch.output.level;
+    auto target = level.value * 0.5f;
+    synth->handleParamValue(&level, level.meta.id, target);
+    synth->process(nullptr);
+    REQUIRE(level.value != target);
+
+    auto &saved = synth->patchForStream();
+    REQUIRE(&saved != &synth->patch);
+    REQUIRE(saved.output.level.value == target);
+    REQUIRE(std::string(saved.name) == std::string(synth->patch.name));
+}
+
+TEST_CASE("Patch image install", "[structure]")
+{
+    auto synth = std::make_unique<Synth>(false);
+    synth->setSampleRate(48000);
+    synth->process(nullptr);
+
+    auto loaded = std::make_unique<Patch>();
+    loaded->output.level.value = synth->patch.output.level.value * 0.25f;
+    strncpy(loaded->macroNames[0].data(), "Brightness", 63);
+
+    Synth::MainToAudioMsg msg{Synth::MainToAudioMsg::INSTALL_PATCH_IMAGE};
+    msg.dawExtraStatePointer = new PatchImage(*loaded, "Loaded");
+    synth->mainToAudio.push(msg);
+    synth->process(nullptr);
+
+    // Taken whole, with no lag towards the new value
+    REQUIRE(synth->patch.output.level.value == loaded->output.level.value);
+    REQUIRE(!synth->patch.output.level.lag.isActive());
+    REQUIRE(std::string(synth->patch.name) == "Loaded");
+    REQUIRE(std::string(synth->patch.macroNames[0].data()) == "Brightness");
+    REQUIRE(!synth->patch.dirty);
+
+    // and handed back for the main thread to free
+    auto retired = synth->retiredPatchImages.pop();
+    REQUIRE(retired.has_value());
+    REQUIRE(std::string((*retired)->name) == "Loaded");
+    delete *retired;
+}
+
+TEST_CASE("Param id index", "[structure]")
+{
+    auto patch = std::make_unique<Patch>();
+    for (const auto &[id, p] : patch->paramMap)
+    {
+        INFO("Param " << id << " " << p->meta.name);
+        REQUIRE(patch->paramById(id) == p);
+    }
+    REQUIRE(patch->paramById(0) == nullptr);
+    REQUIRE(patch->paramById(0xFFFFFFFF) == nullptr);
+}
+
+TEST_CASE("CPU budget sheds voices", "[structure]")
+{
+    auto synth = std::make_unique<Synth>(false);
+    synth->setSampleRate(48000);
+    synth->process(nullptr);
+
+    for (int k = 60; k < 68; ++k)
+        synth->voiceManager->processNoteOnEvent(0, 0, k, -1, 0.8f, 0.f);
+    for (int i = 0; i < 4; ++i)
+        synth->process(nullptr);
+    REQUIRE(synth->voiceCount == 8);
+
+    for (int k = 60; k < 64; ++k)
+        synth->voiceManager->processNoteOffEvent(0, 0, k, -1, 0.f);
+    synth->process(nullptr);
+
+    // Releasing voices go before held ones
+    REQUIRE(synth->shedVoices(2) == 2);
+    REQUIRE(synth->voicesShed == 2);
+    for (auto v = synth->head; v; v = v->next)
+    {
+        if (v->fadeBlocks >= 0)
+            REQUIRE(v->voiceValues.key < 64);
+    }
+
+    for (int i = 0; i < 4 * Voice::fadeOverBlocks; ++i)
+        synth->process(nullptr);
+    REQUIRE(synth->voiceCount >= 4);
+
+    // Loads handed straight to the governor, 512 frame host blocks at 50% budget.
+    // One block at fifty times realtime is a descheduled thread, not a busy synth.
+    synth->applyCpuBudget(50.0, 512, 0.5f);
+    for (int i = 0; i < 200; ++i)
+        synth->applyCpuBudget(0.1, 512, 0.5f);
+    REQUIRE(synth->voicesShed == 2);
+
+    // Sustained load sheds, one voice at a time at this count, releasing ones first
+    int releasing{0};
+    for (auto v = synth->head; v; v = v->next)
+        releasing += !v->voiceValues.gated;
+    int calls{0};
+    while (synth->voicesShed == 2 && calls < 1000)
+    {
+        synth->applyCpuBudget(2.0, 512, 0.5f);
+        calls++;
+    }
+    REQUIRE(synth->voicesShed == 3);
+    REQUIRE(calls * 512 >= 48000 * Synth::budgetWindowSeconds);
+    for (auto v = synth->head; v; v = v->next)
+    {
+        if (v->fadeBlocks >= 0)
+            REQUIRE((v->voiceValues.key < 64) == (releasing > 0));
+    }
+
+    // and held notes go too once it stays over with nothing left releasing
+    for (int i = 0; i < 100000 && synth->voiceCount > 0; ++i)
+    {
+        synth->process(nullptr);
+        synth->applyCpuBudget(2.0, 512, 0.5f);
+    }
+    REQUIRE(synth->voiceCount == 0);
+    REQUIRE(synth->voicesShed >= 2 + 4);
+
+    // A voice fading for any other reason doesn't hold the governor off
+    for (int k = 60; k < 68; ++k)
+        synth->voiceManager->processNoteOnEvent(0, 0, k, -1, 0.8f, 0.f);
+    synth->process(nullptr);
+    synth->responder.terminateVoice(synth->head);
+    auto shedSoFar = synth->voicesShed.load();
+    for (int i = 0; i < 1000 && synth->voicesShed == shedSoFar; ++i)
+        synth->applyCpuBudget(2.0, 512, 0.5f);
+    REQUIRE(synth->voicesShed == shedSoFar + 1);
+}
+
+TEST_CASE("Engine stats", "[structure]")
+{
+    auto synth = std::make_unique<Synth>(false);
+    synth->setSampleRate(48000);
+    // Every engine block timed, so the stage sum can't pass the host time
+    synth->stats.setStageSampleEvery(1);
+    for (int k = 60; k < 65; ++k)
+        synth->voiceManager->processNoteOnEvent(0, 0, k, -1, 0.8f, 0.f);
+    for (int i = 0; i < 32; ++i)
+        synth->process(nullptr);
+
+    // Counted with no editor attached
+    REQUIRE(!synth->isEditorAttached);
+    auto s = synth->stats.read();
+    REQUIRE(s.hostBlocks == 32);
+    REQUIRE(s.frames == 32 * blockSize);
+    REQUIRE(s.engineBlocks > 0);
+    REQUIRE(s.maxHostBlockNs > 0);
+    REQUIRE(s.stageNs[EngineStats::VOICE_RENDER] > 0);
+    REQUIRE(s.stageNs[EngineStats::VOICE_RENDER] <= s.hostNs);
+
+    uint64_t histogramBlocks{0};
+    for (auto b : s.voiceHistogram)
+        histogramBlocks += b;
+    REQUIRE(histogramBlocks == s.engineBlocks);
+    REQUIRE(s.voiceHistogram[EngineStats::bucketFor(5)] > 0);
+    REQUIRE(EngineStats::bucketFor(0) == 0);
+    REQUIRE(EngineStats::bucketFor(5) == 3);
+    REQUIRE(EngineStats::bucketFor(1000) == EngineStats::voiceBuckets - 1);
+
+    // A reset lands at the next host block
+    synth->stats.reset();
+    REQUIRE(synth->stats.read().hostBlocks == 32);
+    synth->process(nullptr);
+    REQUIRE(synth->stats.read().hostBlocks == 1);
+
+    std::ostringstream oss;
+    synth->stats.read().write(oss);
+    REQUIRE(oss.str().find("host_blocks 1\n") != std::string::npos);
+    REQUIRE(oss.str().find("stage voice_render") != std::string::npos);
+
+    // Sampled stages still see the voices; switched off they read no clock at all
+    for (uint32_t every : {EngineStats::defaultStageSampleEvery, 0u})
+    {
+        synth->stats.setStageSampleEvery(every);
+        synth->stats.reset();
+        for (int i = 0; i < 32; ++i)
+            synth->process(nullptr);
+        auto vr = synth->stats.read().stageNs[EngineStats::VOICE_RENDER];
+        REQUIRE((every ? vr > 0 : vr == 0));
+    }
+}
+
+TEST_CASE("Engine stats extension", "[structure]")
+{
+    auto host = makeTestHost();
+    auto *plugin = baconpaul::six_sines::makePlugin(&host, false);
+    REQUIRE(plugin != nullptr);
+    plugin->init(plugin);
+
+    auto *ext = static_cast<const six_sines_plugin_engine_stats *>(
+        plugin->get_extension(plugin, SIX_SINES_EXT_ENGINE_STATS));
+    REQUIRE(ext != nullptr);
+
+    EngineStats::Snapshot s;
+    s.hostBlocks = 17;
+    ext->get(plugin, &s);
+    REQUIRE(s.hostBlocks == 0);
+
+    auto path = fs::temp_directory_path() / "six-sines-engine-stats-test.txt";
+    REQUIRE(ext->write_to_file(plugin, path.u8string().c_str()));
+    std::ifstream ifs(path);
+    std::string first;
+    std::getline(ifs, first);
+    REQUIRE(first == "host_blocks 0");
+    ifs.close();
+    fs::remove(path);
+
+    plugin->destroy(plugin);
+}
+
+/*
+ * An op whose mixer level is zero can't be heard, so it skips its table lookups,
+ * but its envelopes and phase must keep time: bringing the level up mid-note has to
+ * land on the same state as an op which was heard all along.
+ */
+TEST_CASE("Dead ops keep time", "[structure]")
+{
+    auto make = [](float level)
+    {
+        auto s = std::make_unique<Synth>(false);
+        s->setSampleRate(48000);
+        auto &mx = s->patch.mixerNodes[0];
+        s->patch.sourceNodes[0].active.value = 1.f;
+        mx.active.value = 1.f;
+        mx.level.value = level;
+        mx.attack.value = 0.5f;
+        s->process(nullptr);
+        s->voiceManager->processNoteOnEvent(0, 0, 60, -1, 0.8f, 0.f);
+        return s;
+    };
+    auto heard = make(0.8f);
+    auto silent = make(0.f);
+
+    for (int b = 0; b < 20; ++b)
+    {
+        heard->process(nullptr);
+        silent->process(nullptr);
+    }
+    REQUIRE(heard->head->opLive[0]);
+    REQUIRE(!silent->head->opLive[0]);
+
+    silent->patch.mixerNodes[0].level.value = 0.8f;
+    silent->monoValues.paramVersion++;
+    heard->process(nullptr);
+    silent->process(nullptr);
+
+    auto *hv = heard->head;
+    auto *sv = silent->head;
+    REQUIRE(sv->opLive[0]);
+    REQUIRE(sv->src[0].phase == hv->src[0].phase);
+    REQUIRE(sv->src[0].env.outputCache[blockSize - 1] ==
+            hv->src[0].env.outputCache[blockSize - 1]);
+    REQUIRE(hv->mixerNode[0].env.outputCache[blockSize - 1] < 1.f);
+    REQUIRE(sv->mixerNode[0].env.outputCache[blockSize - 1] ==
+            hv->mixerNode[0].env.outputCache[blockSize - 1]);
+}
+
+TEST_CASE("Op buses follow the start delay", "[structure]")
+{
+    static constexpr int delay{5}, blocks{12};
+    auto run = [](int32_t startDelay, bool withLines = true)
+    {
+        auto s = std::make_unique<Synth>(true);
+        s->setSampleRate(48000);
+        if (withLines)
+        {
+            s->prepareStartDelayLines();
+            REQUIRE(s->startDelayLinesReady());
+        }
+        s->patch.sourceNodes[0].active.value = 1.f;
+        s->patch.mixerNodes[0].active.value = 1.f;
+        s->patch.mixerNodes[0].level.value = 0.8f;
+        s->process(nullptr);
+        s->monoValues.voiceStartDelay = startDelay;
+        s->voiceManager->processNoteOnEvent(0, 0, 60, -1, 0.8f, 0.f);
+        s->monoValues.voiceStartDelay = 0;
+
+        std::vector<float> main, bus;
+        for (int b = 0; b < blocks; ++b)
+        {
+            s->process(nullptr);
+            auto *v = s->head;
+            REQUIRE(v);
+            REQUIRE((v->out.opOutputMask & 1u));
+            main.insert(main.end(), v->out.output[0], v->out.output[0] + blockSize);
+            bus.insert(bus.end(), v->out.opOutput[0][0], v->out.opOutput[0][0] + blockSize);
+        }
+        return std::make_pair(main, bus);
+    };
+    auto [main0, bus0] = run(0);
+    auto [mainD, busD] = run(delay);
+
+    // With no lines allocated a voice ignores the delay
+    auto [mainN, busN] = run(delay, false);
+    REQUIRE(mainN == main0);
+    REQUIRE(busN == bus0);
+
+    for (int i = 0; i < delay; ++i)
+    {
+        REQUIRE(mainD[i] == 0.f);
+        REQUIRE(busD[i] == 0.f);
+    }
+    for (size_t i = delay; i < main0.size(); ++i)
+    {
+        INFO("Sample " << i);
+        REQUIRE(mainD[i] == main0[i - delay]);
+        REQUIRE(busD[i] == bus0[i - delay]);
+    }
+    REQUIRE(*std::max_element(bus0.begin(), bus0.end()) > 0.f);
+}
+
+TEST_CASE("Sample accurate onsets follow the host offset", "[structure]")
+{
+    // At the default 2.5x oversample a host block takes two or three engine blocks,
+    // so what the resampler holds past the host position changes from one host
+    // block to the next. Fire one note in each of two neighbouring host blocks at
+    // every offset and find where the output first crosses a level, interpolated
+    // between samples. Relative to the event that can only move by the rounding to
+    // an engine sample.
+    static constexpr int blocks{48};
+    auto onset = [](uint32_t fireAt)
+    {
+        auto s = std::make_unique<Synth>(false);
+        s->setSampleRate(48000);
+        s->patch.output.eventTiming.value = ET_SAMPLE_ACCURATE;
+        s->prepareStartDelayLines();
+        s->patch.sourceNodes[0].active.value = 1.f;
+        s->patch.mixerNodes[0].active.value = 1.f;
+        s->patch.mixerNodes[0].level.value = 0.8f;
+
+        std::vector<float> l(blocks * blockSize), r(blocks * blockSize);
+        float *outs[2]{l.data(), r.data()};
+        bool fired{false};
+        s->processBlock((uint32_t)l.size(), outs, nullptr, nullptr, nullptr,
+                        [&](uint32_t at)
+                        {
+                            if (!fired && at >= fireAt)
+                            {
+                                s->voiceManager->processNoteOnEvent(0, 0, 60, -1, 0.8f, 0.f);
+                                fired = true;
+                            }
+                            return fired ? std::numeric_limits<uint32_t>::max() : fireAt;
+                        });
+        REQUIRE(fired);
+
+        float peak{0};
+        for (auto v : l)
+            peak = std::max(peak, std::fabs(v));
+        REQUIRE(peak > 0.f);
+
+        auto level = 0.05f * peak;
+        for (size_t i = 1; i < l.size(); ++i)
+        {
+            auto a = std::fabs(l[i - 1]), b = std::fabs(l[i]);
+            if (b >= level)
+                return (double)(i - 1) + (level - a) / (b - a) - fireAt;
+        }
+        FAIL("No onset");
+        return 0.0;
+    };
+
+    const auto firstBlock = 16;
+    const auto ref = onset(firstBlock * blockSize);
+    REQUIRE(ref > 0.0);
+    for (int b = firstBlock; b < firstBlock + 2; ++b)
+    {
+        for (int off = 0; off < blockSize; ++off)
+        {
+            INFO("Block " << b << " offset " << off);
+            REQUIRE(onset(b * blockSize + off) == Approx(ref).margin(0.3));
+        }
+    }
+}
+
+TEST_CASE("Held envelopes match a recompute", "[structure]")
+{
+    auto make = [](bool reuse)
+    {
+        auto s = std::make_unique<Synth>(false);
+        s->setSampleRate(48000);
+        s->monoValues.reuseHeldBlocks = reuse;
+        s->patch.sourceNodes[0].active.value = 1.f;
+        auto &mx = s->patch.mixerNodes[0];
+        mx.active.value = 1.f;
+        mx.level.value = 0.8f;
+        mx.attack.value = 0.1f;
+        mx.decay.value = 0.2f;
+        mx.sustain.value = 0.6f;
+        s->process(nullptr);
+        s->voiceManager->processNoteOnEvent(0, 0, 60, -1, 0.8f, 0.f);
+        return s;
+    };
+    auto reused = make(true);
+    auto recomputed = make(false);
+
+    bool sawHeld{false};
+    auto step = [&](int blocks)
+    {
+        for (int b = 0; b < blocks; ++b)
+        {
+            reused->process(nullptr);
+            recomputed->process(nullptr);
+            auto *rv = reused->head;
+            auto *cv = recomputed->head;
+            REQUIRE(rv);
+            REQUIRE(cv);
+            sawHeld = sawHeld || rv->mixerNode[0].envHeld;
+            REQUIRE(std::memcmp(rv->mixerNode[0].env.outputCache,
+                                cv->mixerNode[0].env.outputCache,
+                                sizeof(cv->mixerNode[0].env.outputCache)) == 0);
+            REQUIRE(std::memcmp(rv->output[0], cv->output[0], blockSize * sizeof(float)) == 0);
+        }
+    };
+
+    // Through attack and decay to a held sustain
+    step(4000);
+    REQUIRE(sawHeld);
+
+    // A sustain move releases the hold and settles again
+    for (auto *s : {reused.get(), recomputed.get()})
+    {
+        s->patch.mixerNodes[0].sustain.value = 0.3f;
+        s->monoValues.paramVersion++;
+    }
+    step(2000);
+
+    // And the release starts from the held value
+    for (auto *s : {reused.get(), recomputed.get()})
+        s->voiceManager->processNoteOffEvent(0, 0, 60, -1, 0.f);
+    step(64);
+}
+
+TEST_CASE("A glide moves the param set version only at its ends", "[structure]")
+{
+    auto s = std::make_unique<Synth>(false);
+    s->setSampleRate(48000);
+    s->process(nullptr);
+
+    auto &level = s->patch.mixerNodes[0].level;
+    auto set0 = s->monoValues.paramSetVersion;
+    auto v0 = s->monoValues.paramVersion;
+    auto target = level.value * 0.5f + 0.1f;
+    s->handleParamValue(&level, level.meta.id, target);
+    REQUIRE(s->monoValues.paramSetVersion == set0 + 1);
+
+    // Routing follows every block of the glide, the LFO caches don't
+    s->process(nullptr);
+    REQUIRE(level.lag.isActive());
+    REQUIRE(s->monoValues.paramVersion > v0 + 1);
+    REQUIRE(s->monoValues.paramSetVersion == set0 + 1);
+
+    for (int i = 0; i < 1000 && level.lag.isActive(); ++i)
+        s->process(nullptr);
+    REQUIRE(!level.lag.isActive());
+    REQUIRE(level.value == Approx(target));
+    REQUIRE(s->monoValues.paramSetVersion == set0 + 2);
+}